@@ -0,0 +1,305 @@
+#ifndef _RESULT_CACHE_CPP
+#define _RESULT_CACHE_CPP
+
+#include <iostream>
+#include <cstring>
+#include <fstream>
+#include "result_cache.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+using namespace cv;
+
+CacheStats::CacheStats()
+    :hits(0), misses(0), evictions(0), store_hits(0), store_writes(0), store_overwrites(0)
+{
+}
+
+static inline uint64 mixWord(uint64 h, uint64 word)
+{
+    h ^= word * CV_BIG_UINT(0x9E3779B97F4A7C15);
+    h = (h << 31) | (h >> 33);
+    return h * CV_BIG_UINT(0xC2B2AE3D27D4EB4F);
+}
+
+static inline uint64 finalizeHash(uint64 h)
+{
+    h ^= h >> 33;
+    h *= CV_BIG_UINT(0xFF51AFD7ED558CCD);
+    h ^= h >> 33;
+    return h;
+}
+
+// 64-bit hash of the pixel data, eight bytes at a time, row by row
+uint64 hashPixels(const Mat& image)
+{
+    uint64 h = mixWord(CV_BIG_UINT(0x243F6A8885A308D3), ((uint64)image.rows << 32) | (uint64)image.cols);
+    h = mixWord(h, (uint64)image.type());
+
+    size_t row_bytes = image.cols * image.elemSize();
+    for(int i = 0; i < image.rows; ++i)
+    {
+        const uchar* row = image.ptr(i);
+        size_t j = 0;
+        for(; j + 8 <= row_bytes; j += 8)
+        {
+            uint64 word;
+            memcpy(&word, row + j, 8);
+            h = mixWord(h, word);
+        }
+
+        uint64 tail = 0;
+        memcpy(&tail, row + j, row_bytes - j);
+        h = mixWord(h, tail);
+    }
+    return finalizeHash(h);
+}
+
+uint64 hashString(const string& text)
+{
+    uint64 h = CV_BIG_UINT(0xCBF29CE484222325);
+    for(size_t i = 0; i < text.size(); ++i)
+    {
+        h ^= (uchar)text[i];
+        h *= CV_BIG_UINT(0x100000001B3);
+    }
+    return h;
+}
+
+/*
+ * 64-bit hash of the contents of a file (0 if it cannot be read), so that
+ * a configuration naming a cascade file changes when the file is replaced
+ */
+uint64 hashFile(const string& path)
+{
+    ifstream file(path.c_str(), ios::in | ios::binary);
+    if(!file)
+        return 0;
+
+    uint64 h = CV_BIG_UINT(0x13198A2E03707344);
+    char buffer[1 << 16];
+    while(file)
+    {
+        file.read(buffer, sizeof(buffer));
+        size_t bytes = (size_t)file.gcount();
+        h = mixWord(h, (uint64)bytes);
+
+        size_t j = 0;
+        for(; j + 8 <= bytes; j += 8)
+        {
+            uint64 word;
+            memcpy(&word, buffer + j, 8);
+            h = mixWord(h, word);
+        }
+
+        uint64 tail = 0;
+        memcpy(&tail, buffer + j, bytes - j);
+        h = mixWord(h, tail);
+    }
+    return finalizeHash(h);
+}
+
+// Key of an image under a given cascade/parameter configuration (0 is reserved)
+uint64 cacheKey(const Mat& image, const string& config)
+{
+    uint64 key = finalizeHash(mixWord(hashPixels(image), hashString(config)));
+    return (key == 0) ? 1 : key;
+}
+
+ResultCache::ResultCache(size_t _capacity)
+    :capacity(_capacity), store_fd(-1), store(NULL), store_slots(0)
+{
+}
+
+ResultCache::~ResultCache()
+{
+    closeStore();
+}
+
+/*
+ * Map (creating it if needed) a store of the given number of slots. Each
+ * slot holds the key, STORE_FORMAT, the two counts and the data of one
+ * result; results that do not fit in a slot are kept in memory only.
+ */
+bool ResultCache::openStore(const string& store_path, size_t slots)
+{
+    closeStore();
+#if defined(__unix__) || defined(__APPLE__)
+    store_fd = open(store_path.c_str(), O_RDWR | O_CREAT, 0644);
+    if(store_fd < 0)
+        return false;
+
+    size_t store_bytes = slots * STORE_SLOT_BYTES;
+    struct stat st;
+    if(fstat(store_fd, &st) != 0 || ((size_t)st.st_size != store_bytes && ftruncate(store_fd, store_bytes) != 0))
+    {
+        closeStore();
+        return false;
+    }
+
+    void* mapping = mmap(NULL, store_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, store_fd, 0);
+    if(mapping == MAP_FAILED)
+    {
+        closeStore();
+        return false;
+    }
+    store = (uchar*)mapping;
+    store_slots = slots;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ResultCache::closeStore()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    if(store)
+        munmap(store, store_slots * STORE_SLOT_BYTES);
+    if(store_fd >= 0)
+        close(store_fd);
+#endif
+    store = NULL;
+    store_fd = -1;
+    store_slots = 0;
+}
+
+bool ResultCache::lookup(uint64 key, CachedResult& result)
+{
+    map<uint64, EntryList::iterator>::iterator it = index.find(key);
+    if(it != index.end())
+    {
+        entries.splice(entries.begin(), entries, it->second);
+        result = it->second->second;
+        ++stats.hits;
+        return true;
+    }
+
+    if(readStore(key, result))
+    {
+        insertMemory(key, result);
+        ++stats.hits;
+        ++stats.store_hits;
+        return true;
+    }
+
+    ++stats.misses;
+    return false;
+}
+
+void ResultCache::insert(uint64 key, const CachedResult& result)
+{
+    insertMemory(key, result);
+    writeStore(key, result);
+}
+
+void ResultCache::insertMemory(uint64 key, const CachedResult& result)
+{
+    map<uint64, EntryList::iterator>::iterator it = index.find(key);
+    if(it != index.end())
+    {
+        it->second->second = result;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+
+    entries.push_front(make_pair(key, result));
+    index[key] = entries.begin();
+    while(entries.size() > capacity)
+    {
+        index.erase(entries.back().first);
+        entries.pop_back();
+        ++stats.evictions;
+    }
+}
+
+bool ResultCache::readStore(uint64 key, CachedResult& result)
+{
+    if(!store)
+        return false;
+
+    const uchar* slot = store + (key % store_slots) * STORE_SLOT_BYTES;
+    uint64 slot_key;
+    int format, sizes[2];
+    memcpy(&slot_key, slot, sizeof(slot_key));
+    memcpy(&format, slot + sizeof(slot_key), sizeof(format));
+    if(slot_key != key || format != STORE_FORMAT)
+        return false;
+    memcpy(sizes, slot + sizeof(slot_key) + sizeof(format), sizeof(sizes));
+    size_t record_bytes = sizeof(slot_key) + sizeof(format) + sizeof(sizes) + sizes[0] * sizeof(int) +
+        sizes[1] * 4 * sizeof(int);
+    if(sizes[0] < 0 || sizes[1] < 0 || record_bytes > STORE_SLOT_BYTES)
+        return false;
+
+    const uchar* data = slot + sizeof(slot_key) + sizeof(format) + sizeof(sizes);
+    result.counts.resize(sizes[0]);
+    result.rects.resize(sizes[1]);
+    for(int i = 0; i < sizes[0]; ++i, data += sizeof(int))
+        memcpy(&result.counts[i], data, sizeof(int));
+    for(int i = 0; i < sizes[1]; ++i)
+    {
+        int r[4];
+        memcpy(r, data, sizeof(r));
+        data += sizeof(r);
+        result.rects[i] = Rect(r[0], r[1], r[2], r[3]);
+    }
+    return true;
+}
+
+void ResultCache::writeStore(uint64 key, const CachedResult& result)
+{
+    if(!store)
+        return;
+
+    int format = STORE_FORMAT;
+    int sizes[2] = { (int)result.counts.size(), (int)result.rects.size() };
+    size_t record_bytes = sizeof(key) + sizeof(format) + sizeof(sizes) + sizes[0] * sizeof(int) +
+        sizes[1] * 4 * sizeof(int);
+    if(record_bytes > STORE_SLOT_BYTES)
+        return;
+
+    uchar* slot = store + (key % store_slots) * STORE_SLOT_BYTES;
+    uint64 slot_key;
+    memcpy(&slot_key, slot, sizeof(slot_key));
+    if(slot_key != 0 && slot_key != key)
+        ++stats.store_overwrites;
+
+    // The key is written last so that a torn write never matches
+    uint64 empty_key = 0;
+    memcpy(slot, &empty_key, sizeof(empty_key));
+    uchar* data = slot + sizeof(key);
+    memcpy(data, &format, sizeof(format));
+    data += sizeof(format);
+    memcpy(data, sizes, sizeof(sizes));
+    data += sizeof(sizes);
+    for(int i = 0; i < sizes[0]; ++i, data += sizeof(int))
+        memcpy(data, &result.counts[i], sizeof(int));
+    for(int i = 0; i < sizes[1]; ++i)
+    {
+        int r[4] = { result.rects[i].x, result.rects[i].y, result.rects[i].width, result.rects[i].height };
+        memcpy(data, r, sizeof(r));
+        data += sizeof(r);
+    }
+    memcpy(slot, &key, sizeof(key));
+    ++stats.store_writes;
+}
+
+CacheStats ResultCache::getStats() const
+{
+    return stats;
+}
+
+void ResultCache::printStats() const
+{
+    cout << "Result cache: " << stats.hits << " hits (" << stats.store_hits << " from store), "
+        << stats.misses << " misses, " << stats.evictions << " evictions from memory, "
+        << stats.store_writes << " store writes (" << stats.store_overwrites << " replacing another result)\n";
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef _RESULT_CACHE_H
+#define _RESULT_CACHE_H
+
+#include <list>
+#include <map>
+#include "opencv2/core/core.hpp"
+
+using namespace std;
+using namespace cv;
+
+// Size of one record of the on-disk store
+#define STORE_SLOT_BYTES 1024
+
+// Layout version of a store record, records of another layout never match
+#define STORE_FORMAT 0x52430002
+
+/*
+ * Face and feature rectangles computed for one image. The grouping of
+ * rects is up to the program storing them; counts describes that grouping.
+ */
+struct CachedResult
+{
+    vector<int> counts;
+    vector<Rect_<int> > rects;
+};
+
+struct CacheStats
+{
+    int64 hits;
+    int64 misses;
+    int64 evictions;                            // results dropped from the in-memory LRU
+    int64 store_hits;
+    int64 store_writes;
+    int64 store_overwrites;                     // store slots that held the result of another key
+
+    CacheStats();
+};
+
+uint64 hashPixels(const Mat& image);
+uint64 hashString(const string& text);
+uint64 hashFile(const string& path);
+uint64 cacheKey(const Mat& image, const string& config);
+
+/*
+ * Bounded LRU cache of results keyed by cacheKey(), optionally backed by a
+ * memory-mapped file of fixed-size slots (direct mapped by key) that
+ * survives between runs. Lookups that miss in memory fall through to the
+ * store and are promoted back into memory.
+ */
+class ResultCache
+{
+    private:
+        typedef list<pair<uint64, CachedResult> > EntryList;
+
+        size_t capacity;
+        EntryList entries;                          // most recently used first
+        map<uint64, EntryList::iterator> index;
+        int store_fd;
+        uchar* store;
+        size_t store_slots;
+        CacheStats stats;
+
+        void insertMemory(uint64 key, const CachedResult& result);
+        bool readStore(uint64 key, CachedResult& result);
+        void writeStore(uint64 key, const CachedResult& result);
+
+        ResultCache(const ResultCache&);
+        ResultCache& operator=(const ResultCache&);
+
+    public:
+        explicit ResultCache(size_t _capacity);
+        ~ResultCache();
+        bool openStore(const string& store_path, size_t slots);
+        void closeStore();
+        bool lookup(uint64 key, CachedResult& result);
+        void insert(uint64 key, const CachedResult& result);
+        CacheStats getStats() const;
+        void printStats() const;
+};
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef _CASCADE_PROFILE_CPP
+#define _CASCADE_PROFILE_CPP
+
+#include "cascade_profile.h"
+#include "perf_profile.h"
+using namespace std;
+using namespace cv;
+
+CascadeParams::CascadeParams()
+    :scale_factor(1.20), min_neighbors(5), min_size(30, 30), max_size()
+{
+}
+
+CascadeParams::CascadeParams(double _scale_factor, int _min_neighbors, Size _min_size, Size _max_size)
+    :scale_factor(_scale_factor), min_neighbors(_min_neighbors), min_size(_min_size), max_size(_max_size)
+{
+}
+
+// The parameters the programs were originally tuned with
+CascadeParams defaultCascadeParams(const string& cascade_name)
+{
+    if(cascade_name == "face")
+        return CascadeParams(1.15, 3, Size(30, 30), Size());
+    return CascadeParams(1.20, 5, Size(30, 30), Size());
+}
+
+CascadeProfile::CascadeProfile()
+    :face_detector("haar")
+{
+}
+
+/*
+ * Expected layout (YAML shown, XML works as well):
+ *
+ * face_detector: haar
+ * face:
+ *    scale_factor: 1.15
+ *    min_neighbors: 3
+ *    min_width: 30
+ *    min_height: 30
+ *    max_width: 0
+ *    max_height: 0
+ */
+bool CascadeProfile::load(const string& profile_path)
+{
+    FileStorage fs(profile_path, FileStorage::READ);
+    if(!fs.isOpened())
+        return false;
+
+    if(!fs["face_detector"].empty())
+        face_detector = (string)fs["face_detector"];
+
+    const char* cascade_names[] = { "face", "eyes", "nose", "mouth" };
+    for(int i = 0; i < 4; ++i)
+    {
+        FileNode node = fs[cascade_names[i]];
+        if(node.empty())
+            continue;
+
+        CascadeParams p = defaultCascadeParams(cascade_names[i]);
+        if(!node["scale_factor"].empty())
+            p.scale_factor = (double)node["scale_factor"];
+        if(!node["min_neighbors"].empty())
+            p.min_neighbors = (int)node["min_neighbors"];
+        if(!node["min_width"].empty() && !node["min_height"].empty())
+            p.min_size = Size((int)node["min_width"], (int)node["min_height"]);
+        if(!node["max_width"].empty() && !node["max_height"].empty())
+            p.max_size = Size((int)node["max_width"], (int)node["max_height"]);
+        params[cascade_names[i]] = p;
+    }
+    return true;
+}
+
+bool CascadeProfile::save(const string& profile_path) const
+{
+    FileStorage fs(profile_path, FileStorage::WRITE);
+    if(!fs.isOpened())
+        return false;
+
+    fs << "face_detector" << face_detector;
+    for(map<string, CascadeParams>::const_iterator it = params.begin(); it != params.end(); ++it)
+    {
+        const CascadeParams& p = it->second;
+        fs << it->first << "{"
+            << "scale_factor" << p.scale_factor
+            << "min_neighbors" << p.min_neighbors
+            << "min_width" << p.min_size.width << "min_height" << p.min_size.height
+            << "max_width" << p.max_size.width << "max_height" << p.max_size.height
+            << "}";
+    }
+    return true;
+}
+
+void CascadeProfile::set(const string& cascade_name, const CascadeParams& _params)
+{
+    params[cascade_name] = _params;
+}
+
+CascadeParams CascadeProfile::get(const string& cascade_name) const
+{
+    map<string, CascadeParams>::const_iterator it = params.find(cascade_name);
+    if(it == params.end())
+        return defaultCascadeParams(cascade_name);
+    return it->second;
+}
+
+void CascadeProfile::setFaceDetector(const string& backend)
+{
+    face_detector = backend;
+}
+
+string CascadeProfile::getFaceDetector() const
+{
+    return face_detector;
+}
+
+void runCascade(CascadeClassifier& cascade, const Mat& image, vector<Rect_<int> >& objects,
+        const CascadeParams& params)
+{
+    PerfScope scope("detectMultiScale", image.total());
+    cascade.detectMultiScale(image, objects, params.scale_factor, params.min_neighbors,
+            0|CASCADE_SCALE_IMAGE, params.min_size, params.max_size);
+    return;
+}
+
+#endif
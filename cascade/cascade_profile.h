@@ -0,0 +1,49 @@
+#ifndef _CASCADE_PROFILE_H
+#define _CASCADE_PROFILE_H
+
+#include <map>
+#include "opencv2/core/core.hpp"
+#include "opencv2/objdetect/objdetect.hpp"
+
+using namespace std;
+using namespace cv;
+
+// detectMultiScale() parameters for a single cascade
+struct CascadeParams
+{
+    double scale_factor;
+    int min_neighbors;
+    Size min_size;
+    Size max_size;          // Size() means no upper bound
+
+    CascadeParams();
+    CascadeParams(double _scale_factor, int _min_neighbors, Size _min_size, Size _max_size);
+};
+
+/*
+ * Tuning profile holding one CascadeParams entry per cascade ("face",
+ * "eyes", "nose", "mouth"), stored as an OpenCV FileStorage (YAML/XML)
+ * file. Cascades missing from the profile keep the default parameters.
+ * The profile also names the face detection backend (see face_detector.h).
+ */
+class CascadeProfile
+{
+    private:
+        map<string, CascadeParams> params;
+        string face_detector;
+
+    public:
+        CascadeProfile();
+        bool load(const string& profile_path);
+        bool save(const string& profile_path) const;
+        void set(const string& cascade_name, const CascadeParams& _params);
+        CascadeParams get(const string& cascade_name) const;
+        void setFaceDetector(const string& backend);
+        string getFaceDetector() const;
+};
+
+CascadeParams defaultCascadeParams(const string& cascade_name);
+void runCascade(CascadeClassifier& cascade, const Mat& image, vector<Rect_<int> >& objects,
+        const CascadeParams& params);
+
+#endif
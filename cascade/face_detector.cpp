@@ -0,0 +1,49 @@
+#ifndef _FACE_DETECTOR_CPP
+#define _FACE_DETECTOR_CPP
+
+#include "face_detector.h"
+using namespace std;
+using namespace cv;
+
+// Feature types reported by CascadeClassifier::getFeatureType()
+#define CASCADE_FEATURE_HAAR 0
+#define CASCADE_FEATURE_LBP 1
+
+FaceDetector::~FaceDetector()
+{
+}
+
+CascadeFaceDetector::CascadeFaceDetector(int _feature_type, const string& _backend_name)
+    :feature_type(_feature_type), backend_name(_backend_name)
+{
+}
+
+// Fails if the file is not a cascade of this backend's feature type
+bool CascadeFaceDetector::load(const string& model_path)
+{
+    if(!cascade.load(model_path))
+        return false;
+    return (cascade.getFeatureType() == feature_type);
+}
+
+void CascadeFaceDetector::detect(const Mat& image, vector<Rect_<int> >& faces, const CascadeParams& params)
+{
+    runCascade(cascade, image, faces, params);
+    return;
+}
+
+string CascadeFaceDetector::name() const
+{
+    return backend_name;
+}
+
+Ptr<FaceDetector> createFaceDetector(const string& backend)
+{
+    if(backend == "haar")
+        return Ptr<FaceDetector>(new CascadeFaceDetector(CASCADE_FEATURE_HAAR, "haar"));
+    if(backend == "lbp")
+        return Ptr<FaceDetector>(new CascadeFaceDetector(CASCADE_FEATURE_LBP, "lbp"));
+    return Ptr<FaceDetector>();
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef _FACE_DETECTOR_H
+#define _FACE_DETECTOR_H
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/objdetect/objdetect.hpp"
+
+#include "cascade_profile.h"
+
+using namespace std;
+using namespace cv;
+
+// Interface shared by the face detection backends
+class FaceDetector
+{
+    public:
+        virtual ~FaceDetector();
+        virtual bool load(const string& model_path) = 0;
+        virtual void detect(const Mat& image, vector<Rect_<int> >& faces, const CascadeParams& params) = 0;
+        virtual string name() const = 0;
+};
+
+/*
+ * Cascade backend restricted to one feature type. Haar features need
+ * floating-point stage sums and a squared integral image for variance
+ * normalisation; LBP features are evaluated with integer integral-image
+ * sums and lookup tables only, which makes the LBP cascade the integer
+ * backend and usually several times faster.
+ */
+class CascadeFaceDetector : public FaceDetector
+{
+    private:
+        CascadeClassifier cascade;
+        int feature_type;
+        string backend_name;
+
+    public:
+        CascadeFaceDetector(int _feature_type, const string& _backend_name);
+        virtual bool load(const string& model_path);
+        virtual void detect(const Mat& image, vector<Rect_<int> >& faces, const CascadeParams& params);
+        virtual string name() const;
+};
+
+// "haar" or "lbp"; returns an empty pointer for unknown backends
+Ptr<FaceDetector> createFaceDetector(const string& backend);
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef _TILED_DETECTION_CPP
+#define _TILED_DETECTION_CPP
+
+#include <algorithm>
+#include "tiled_detection.h"
+using namespace std;
+using namespace cv;
+
+TilingParams::TilingParams()
+    :max_face(0), memory_budget(512 << 20)
+{
+}
+
+TilingParams::TilingParams(int _max_face, size_t _memory_budget)
+    :max_face(_max_face), memory_budget(_memory_budget)
+{
+}
+
+/*
+ * Split the image into square tiles of TILE_FACES * max_face pixels that
+ * overlap by max_face + 1 pixels. detectTiled() drops detections touching
+ * an inner tile edge, so a face needs a pixel of margin on those sides;
+ * with this overlap every face no larger than max_face lies strictly
+ * inside at least one tile.
+ */
+vector<Rect_<int> > computeTiles(Size image_size, int max_face)
+{
+    vector<Rect_<int> > tiles;
+    int tile_side = TILE_FACES * max_face;
+    int stride = tile_side - max_face - 1;
+
+    for(int y = 0; ; y += stride)
+    {
+        int tile_y = min(y, max(image_size.height - tile_side, 0));
+        for(int x = 0; ; x += stride)
+        {
+            int tile_x = min(x, max(image_size.width - tile_side, 0));
+            tiles.push_back(Rect(tile_x, tile_y, min(tile_side, image_size.width - tile_x),
+                        min(tile_side, image_size.height - tile_y)));
+            if(tile_x + tile_side >= image_size.width)
+                break;
+        }
+        if(tile_y + tile_side >= image_size.height)
+            break;
+    }
+    return tiles;
+}
+
+// Intersection over union of two rectangles
+double overlapRatio(const Rect_<int>& a, const Rect_<int>& b)
+{
+    int intersection = (a & b).area();
+    int union_area = a.area() + b.area() - intersection;
+    return (union_area > 0) ? (double)intersection / union_area : 0.0;
+}
+
+static bool largerArea(const Rect_<int>& a, const Rect_<int>& b)
+{
+    return a.area() > b.area();
+}
+
+// Non-maximum suppression: keep the larger of two detections overlapping by more than max_overlap
+void mergeDetections(vector<Rect_<int> >& objects, double max_overlap)
+{
+    sort(objects.begin(), objects.end(), largerArea);
+
+    vector<Rect_<int> > merged;
+    for(unsigned int i = 0; i < objects.size(); ++i)
+    {
+        bool is_duplicate = false;
+        for(unsigned int j = 0; j < merged.size() && !is_duplicate; ++j)
+            is_duplicate = (overlapRatio(objects[i], merged[j]) > max_overlap);
+        if(!is_duplicate)
+            merged.push_back(objects[i]);
+    }
+    objects.swap(merged);
+    return;
+}
+
+/*
+ * Runs one tile per index. Tiles of the same batch use distinct
+ * detectors because CascadeClassifier keeps per-image state.
+ */
+class TileDetector : public ParallelLoopBody
+{
+    private:
+        vector<Ptr<FaceDetector> >& detectors;
+        const Mat& image;
+        const vector<Rect_<int> >& tiles;
+        vector<vector<Rect_<int> > >& tile_objects;
+        const CascadeParams& params;
+
+    public:
+        TileDetector(vector<Ptr<FaceDetector> >& _detectors, const Mat& _image,
+                const vector<Rect_<int> >& _tiles, vector<vector<Rect_<int> > >& _tile_objects,
+                const CascadeParams& _params)
+            :detectors(_detectors), image(_image), tiles(_tiles), tile_objects(_tile_objects), params(_params)
+        {
+        }
+
+        virtual void operator()(const Range& range) const
+        {
+            for(int i = range.start; i < range.end; ++i)
+            {
+                FaceDetector& detector = *detectors[i % detectors.size()];
+                detector.detect(image(tiles[i]), tile_objects[i], params);
+            }
+        }
+};
+
+/*
+ * Number of tiles to run at the same time: one per thread, as many as fit
+ * in the memory budget and at least one.
+ */
+int tileWorkers(Size image_size, const TilingParams& tiling)
+{
+    if(tiling.max_face <= 0)
+        return 1;
+
+    int tiles = (int)computeTiles(image_size, tiling.max_face).size();
+    size_t tile_bytes = (size_t)TILE_FACES * tiling.max_face * TILE_FACES * tiling.max_face *
+        TILE_BYTES_PER_PIXEL;
+    int workers = (int)min((size_t)getNumThreads(), tiling.memory_budget / max(tile_bytes, (size_t)1));
+    return max(min(workers, tiles), 1);
+}
+
+/*
+ * Grow the detector pool to count detectors of the given backend. The
+ * detectors already in the pool are kept, so a caller that keeps its
+ * pool across frames parses the model only once per worker.
+ */
+bool loadDetectors(const string& backend, const string& model_path, int count,
+        vector<Ptr<FaceDetector> >& detectors)
+{
+    while((int)detectors.size() < count)
+    {
+        Ptr<FaceDetector> detector = createFaceDetector(backend);
+        if(detector.empty() || !detector->load(model_path))
+            return false;
+        detectors.push_back(detector);
+    }
+    return true;
+}
+
+/*
+ * Detect faces tile by tile so that the scale pyramid never grows beyond
+ * a tile. As many tiles run in parallel as there are loaded detectors, up
+ * to tileWorkers(). Detections touching an inner tile border are dropped
+ * since the face is seen whole in the neighbouring tile, and the
+ * duplicates along the seams are merged, which reproduces the full-image
+ * result up to the window positions of the scan.
+ */
+void detectTiled(vector<Ptr<FaceDetector> >& detectors, const Mat& image,
+        vector<Rect_<int> >& objects, const CascadeParams& params, const TilingParams& tiling)
+{
+    CV_Assert(!detectors.empty());
+
+    objects.clear();
+    if(tiling.max_face <= 0)
+    {
+        detectors[0]->detect(image, objects, params);
+        return;
+    }
+
+    // Faces larger than max_face cannot be found whole in a tile, so do not look for them
+    CascadeParams tile_params = params;
+    if(tile_params.max_size.width == 0 || tile_params.max_size.width > tiling.max_face)
+        tile_params.max_size = Size(tiling.max_face, tiling.max_face);
+
+    vector<Rect_<int> > tiles = computeTiles(image.size(), tiling.max_face);
+    int workers = min(tileWorkers(image.size(), tiling), (int)detectors.size());
+
+    vector<vector<Rect_<int> > > tile_objects(tiles.size());
+    TileDetector tile_detector(detectors, image, tiles, tile_objects, tile_params);
+    for(int start = 0; start < (int)tiles.size(); start += workers)
+        parallel_for_(Range(start, min(start + workers, (int)tiles.size())), tile_detector);
+
+    for(unsigned int i = 0; i < tiles.size(); ++i)
+    {
+        Rect_<int> tile = tiles[i];
+        for(unsigned int j = 0; j < tile_objects[i].size(); ++j)
+        {
+            Rect_<int> o = tile_objects[i][j];
+            bool on_inner_border = (o.x == 0 && tile.x > 0) || (o.y == 0 && tile.y > 0) ||
+                (o.x + o.width >= tile.width && tile.x + tile.width < image.cols) ||
+                (o.y + o.height >= tile.height && tile.y + tile.height < image.rows);
+            if(!on_inner_border)
+                objects.push_back(Rect(o.x + tile.x, o.y + tile.y, o.width, o.height));
+        }
+    }
+    mergeDetections(objects, 0.3);
+    return;
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef _TILED_DETECTION_H
+#define _TILED_DETECTION_H
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/objdetect/objdetect.hpp"
+
+#include "cascade_profile.h"
+#include "face_detector.h"
+
+using namespace std;
+using namespace cv;
+
+// Tile side length in multiples of the largest expected face
+#define TILE_FACES 8
+
+// Rough working set of detectMultiScale() per tile pixel (gray copy, pyramid and integral images)
+#define TILE_BYTES_PER_PIXEL 24
+
+struct TilingParams
+{
+    int max_face;           // largest face expected, in pixels (0 disables tiling)
+    size_t memory_budget;   // bytes shared by all tiles processed at the same time
+
+    TilingParams();
+    TilingParams(int _max_face, size_t _memory_budget);
+};
+
+vector<Rect_<int> > computeTiles(Size image_size, int max_face);
+double overlapRatio(const Rect_<int>& a, const Rect_<int>& b);
+void mergeDetections(vector<Rect_<int> >& objects, double max_overlap);
+int tileWorkers(Size image_size, const TilingParams& tiling);
+bool loadDetectors(const string& backend, const string& model_path, int count,
+        vector<Ptr<FaceDetector> >& detectors);
+void detectTiled(vector<Ptr<FaceDetector> >& detectors, const Mat& image,
+        vector<Rect_<int> >& objects, const CascadeParams& params, const TilingParams& tiling);
+
+#endif
@@ -8,9 +8,14 @@
  */
 
 #include "eyebrow_roi.h"
+#include "histogram_threshold.h"
+#include "pixel_kernels.h"
+#include "perf_profile.h"
 
 #include <iostream>
 #include <utility>
+#include <cstdlib>
+#include <algorithm>
 #include "opencv2/imgproc/imgproc.hpp"
 
 using namespace std;
@@ -19,15 +24,21 @@ using namespace cv;
 string input_image_path;
 string face_cascade_path, eye_cascade_path;
 
+// Functions to parse command-line arguments
+static string getCommandOption(const vector<string>&, const string&);
+static void setCommandOptions(vector<string>&, int, char**);
+static bool doesCmdOptionExist(const vector<string>& , const string&);
+
 Mat_<uchar> CRTransform(const Mat& image); 
-Mat_<uchar> exponentialTransform(const Mat_<uchar>& image);
-pair<double, double> returnImageStats(const Mat_<uchar>& image);
-Mat_<uchar> binaryThresholding(const Mat_<uchar>& image, const pair<double, double>& stats);
+Mat_<uchar> exponentialTransform(const Mat_<uchar>& image, Histogram* hist);
+bool extractEyebrowROI(EyebrowROI& eyebrow_detector, Mat& eyebrow_roi);
 int returnLargestContourIndex(vector<vector<Point> > contours);
+bool writeLandmarks(const string& landmarks_path, const string& pipeline, const vector<Point>& landmarks,
+        double pipeline_time);
 
 int main(int argc, char** argv)
 {
-    if(argc != 4)
+    if(argc < 4)
     {
         cout << "Parameters missing!\n";
         return 1;
@@ -37,21 +48,87 @@ int main(int argc, char** argv)
     face_cascade_path = argv[2];
     eye_cascade_path = argv[3];
 
-    Mat_<Vec3b> image_BGR = imread(input_image_path);
+    // Extract command-line options
+    vector<string> args;
+    setCommandOptions(args, argc, argv);
 
-    // Detect faces and eyebrows in image
-    EyebrowROI eyebrow_detector(image_BGR, face_cascade_path, eye_cascade_path);
-    eyebrow_detector.detectEyebrows();
-    vector<Mat> eyebrows_roi = eyebrow_detector.displayROI();
+    // -perf counts cycles, instructions and cache/branch misses per stage
+    if(doesCmdOptionExist(args, "-perf"))
+        perfProfiler().enable();
+
+    // Threshold at mean + 0.9 * std_dev unless another strategy is requested
+    ThresholdStrategy strategy = THRESHOLD_MEAN_STD;
+    double strategy_param = 0.9;
+    if(doesCmdOptionExist(args, "-otsu"))
+        strategy = THRESHOLD_OTSU;
+    else if(doesCmdOptionExist(args, "-percentile"))
+    {
+        strategy = THRESHOLD_PERCENTILE;
+        strategy_param = atof(getCommandOption(args, "-percentile").c_str());
+    }
+
+    // Load detectMultiScale() parameters if a tuning profile is provided
+    CascadeProfile cascade_profile;
+    if(doesCmdOptionExist(args, "-profile") && !cascade_profile.load(getCommandOption(args, "-profile")))
+    {
+        cout << "Unable to read the tuning profile " << getCommandOption(args, "-profile") << "\n";
+        return 1;
+    }
+    if(doesCmdOptionExist(args, "-detector"))
+        cascade_profile.setFaceDetector(getCommandOption(args, "-detector"));
 
-    // Mat_<uchar> image_exp = exponentialTransform(CRTransform(image_BGR));
-    Mat_<uchar> image_exp = exponentialTransform(CRTransform(eyebrows_roi[0]));
-    Mat_<uchar> image_binary = binaryThresholding(image_exp, returnImageStats(image_exp));
+    // -roi takes the input image as the eyebrow ROI itself (the cascades are then ignored)
+    Mat eyebrow_roi;
+    if(doesCmdOptionExist(args, "-roi"))
+        eyebrow_roi = imread(input_image_path);
+    else if(doesCmdOptionExist(args, "-reduce"))
+    {
+        // -reduce N finds the face on a 1/N grayscale decode, the full resolution is kept for the faces only
+        int reduction = atoi(getCommandOption(args, "-reduce").c_str());
+        if(!isReductionSupported(reduction))
+        {
+            cout << "-reduce takes 2, 4 or 8\n";
+            return 1;
+        }
+        ImageIngest ingest(input_image_path, reduction);
+        EyebrowROI eyebrow_detector(ingest, face_cascade_path, eye_cascade_path, cascade_profile);
+        if(!extractEyebrowROI(eyebrow_detector, eyebrow_roi))
+            return 1;
+    }
+    else
+    {
+        // Detect faces and eyebrows in image
+        Mat_<Vec3b> image_BGR = imread(input_image_path);
+        EyebrowROI eyebrow_detector(image_BGR, face_cascade_path, eye_cascade_path, cascade_profile);
+        if(!extractEyebrowROI(eyebrow_detector, eyebrow_roi))
+            return 1;
+    }
+    if(eyebrow_roi.empty())
+    {
+        cout << "No eyebrow region found\n";
+        return 1;
+    }
+    int64 pipeline_start = getTickCount();
+
+    // The histogram is filled by the exponential transform, so thresholding costs O(256)
+    // Mat_<uchar> image_exp = exponentialTransform(CRTransform(image_BGR), &exp_hist);
+    Histogram exp_hist;
+    Mat_<uchar> image_exp = exponentialTransform(CRTransform(eyebrow_roi), &exp_hist);
+    Mat_<uchar> image_binary;
+    {
+        PerfScope scope("threshold", image_exp.total());
+        image_binary = applyThreshold(image_exp, computeThreshold(exp_hist, strategy, strategy_param));
+    }
 
     // A clone image is required because findContours() modifies the input image
-    Mat image_binary_clone = image_binary.clone();
     vector<vector<Point> > contours;
-    findContours(image_binary_clone, contours, CV_RETR_LIST, CV_CHAIN_APPROX_NONE);
+    int largest_contour_idx = -1;
+    {
+        PerfScope scope("contours", image_binary.total());
+        Mat image_binary_clone = image_binary.clone();
+        findContours(image_binary_clone, contours, CV_RETR_LIST, CV_CHAIN_APPROX_NONE);
+        largest_contour_idx = returnLargestContourIndex(contours);
+    }
     
     // Initialize blank image (for drawing contours)
     Mat_<uchar> image_contour(image_binary.size());
@@ -63,11 +140,39 @@ int main(int argc, char** argv)
 
     // Draw largest contour on the blank image
     cout << "Size of the contour image: " << image_contour.rows << " X " << image_contour.cols << "\n";
-    int largest_contour_idx = returnLargestContourIndex(contours);
+    if(largest_contour_idx < 0)
+    {
+        cout << "No eyebrow contour found\n";
+        return 1;
+    }
+
+    // Left end, right end and top of the eyebrow contour
+    Point left_pt = contours[largest_contour_idx][0];
+    Point right_pt = left_pt, top_pt = left_pt;
     for(int i = 0; i < contours[largest_contour_idx].size(); ++i)
     {
         Point_<int> pt = contours[largest_contour_idx][i];
         image_contour.at<uchar>(pt.y, pt.x) = 255;
+
+        if(pt.x < left_pt.x)
+            left_pt = pt;
+        if(pt.x > right_pt.x)
+            right_pt = pt;
+        if(pt.y < top_pt.y)
+            top_pt = pt;
+    }
+    double pipeline_time = (getTickCount() - pipeline_start) * 1000.0 / getTickFrequency();
+    if(perfProfiler().isEnabled())
+        perfProfiler().printReport();
+
+    // -landmarks writes the contour end-points and top instead of showing the contour
+    if(doesCmdOptionExist(args, "-landmarks"))
+    {
+        vector<Point> landmarks;
+        landmarks.push_back(left_pt);
+        landmarks.push_back(right_pt);
+        landmarks.push_back(top_pt);
+        return writeLandmarks(getCommandOption(args, "-landmarks"), "eyebrow", landmarks, pipeline_time) ? 0 : 1;
     }
 
     imshow("Binary-Image", image_binary);
@@ -77,74 +182,68 @@ int main(int argc, char** argv)
     return 0;
 }
 
-Mat_<uchar> CRTransform(const Mat& image)
+void setCommandOptions(vector<string>& args, int argc, char** argv)
 {
-    Mat_<Vec3b> _image = image;
-    Mat_<uchar> CR_image(image.size());
-    for(int i = 0; i < image.rows; ++i)
+    for(int i = 1; i < argc; ++i)
     {
-        for(int j = 0; j < image.cols; ++j)
-            CR_image.at<uchar>(i, j) = (255 - _image(i, j)[2]);
+        args.push_back(argv[i]);
     }
-    return CR_image;
+    return;
 }
 
-Mat_<uchar> exponentialTransform(const Mat_<uchar>& image)
+string getCommandOption(const vector<string>& args, const string& opt)
 {
-    vector<int> exponential_transform(256, 0);
-    for(int i = 0; i < 256; ++i)
-        exponential_transform[i] = round(exp((i * log(255)) / 255));
+    string answer;
+    vector<string>::const_iterator it = find(args.begin(), args.end(), opt);
+    if(it != args.end() && (++it != args.end()))
+        answer = *it;
+    return answer;
+}
 
-    Mat_<uchar> image_exp(image.size());
-    for(int i = 0; i < image.rows; ++i)
-    {
-        for(int j = 0; j < image.cols; ++j)
-            image_exp.at<uchar>(i, j) = exponential_transform[image.at<uchar>(i, j)];
-    }
-    return image_exp;
+bool doesCmdOptionExist(const vector<string>& args, const string& opt)
+{
+    vector<string>::const_iterator it = find(args.begin(), args.end(), opt);
+    return (it != args.end());
 }
 
-pair<double, double> returnImageStats(const Mat_<uchar>& image)
+// Detect faces and eyebrows, eyebrow_roi gets the first eyebrow region found
+bool extractEyebrowROI(EyebrowROI& eyebrow_detector, Mat& eyebrow_roi)
 {
-    double mean = 0.0, std_dev = 0.0;
-    int total_pixels = (image.rows * image.cols);
-    
-    int intensity_sum = 0;
-    for(int i = 0; i < image.rows; ++i)
+    if(!eyebrow_detector.isLoaded())
     {
-        for(int j = 0; j < image.cols; ++j)
-            intensity_sum += image.at<uchar>(i, j);
+        cout << eyebrow_detector.loadError() << "\n";
+        return false;
     }
-    mean = (double)intensity_sum/total_pixels;
 
-    int sum_sq = 0;
-    for(int i = 0; i < image.rows; ++i)
-    {
-        for(int j = 0; j < image.cols; ++j)
-            sum_sq += ( (image.at<uchar>(i, j) - mean) * (image.at<uchar>(i, j) - mean) );
-    }
-    std_dev = sqrt((double)sum_sq/total_pixels);
+    eyebrow_detector.detectEyebrows();
+    vector<Mat> eyebrows_roi = eyebrow_detector.displayROI();
+    if(!eyebrows_roi.empty())
+        eyebrow_roi = eyebrows_roi[0];
+    return true;
+}
 
-    return make_pair(mean, std_dev);
+Mat_<uchar> CRTransform(const Mat& image)
+{
+    PerfScope scope("CR transform", image.total());
+    return CRTransformT<LayoutBGR, uchar>(image);
 }
 
-Mat_<uchar> binaryThresholding(const Mat_<uchar>& image, const pair<double, double>& stats)
+Mat_<uchar> exponentialTransform(const Mat_<uchar>& image, Histogram* hist)
 {
-    Mat_<uchar> image_binary(image.size());
-    
-    double Z = 0.9;
-    double threshold = stats.first + (Z * stats.second); 
+    PerfScope scope("exponential", image.total());
+    vector<int> exponential_transform(256, 0);
+    for(int i = 0; i < 256; ++i)
+        exponential_transform[i] = round(exp((i * log(255)) / 255));
+
+    Mat_<uchar> image_exp(image.size());
     for(int i = 0; i < image.rows; ++i)
     {
         for(int j = 0; j < image.cols; ++j)
-        {
-            if(image.at<uchar>(i, j) >= threshold + numeric_limits<double>::epsilon())
-                image_binary.at<uchar>(i, j) = 255;
-            else
-                image_binary.at<uchar>(i, j) = 0;
-        }
+            image_exp.at<uchar>(i, j) = exponential_transform[image.at<uchar>(i, j)];
+        if(hist)
+            hist->addRow(image_exp[i], image.cols);
     }
-    return image_binary;
+    return image_exp;
 }
 
 int returnLargestContourIndex(vector<vector<Point> > contours)
@@ -161,3 +260,24 @@ int returnLargestContourIndex(vector<vector<Point> > contours)
     }
     return max_contour_idx;
 }
+
+/*
+ * Store the landmarks and the time the pixel pipeline took, in the
+ * format read by the regression harness (see regression/)
+ */
+bool writeLandmarks(const string& landmarks_path, const string& pipeline, const vector<Point>& landmarks,
+        double pipeline_time)
+{
+    FileStorage fs(landmarks_path, FileStorage::WRITE);
+    if(!fs.isOpened())
+    {
+        cout << "Unable to write " << landmarks_path << "\n";
+        return false;
+    }
+
+    fs << "pipeline" << pipeline << "time_ms" << pipeline_time << "landmarks" << "[";
+    for(unsigned int i = 0; i < landmarks.size(); ++i)
+        fs << landmarks[i].x << landmarks[i].y;
+    fs << "]";
+    return true;
+}
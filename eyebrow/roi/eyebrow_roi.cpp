@@ -8,10 +8,26 @@ using namespace cv;
 
 EyebrowROI::EyebrowROI(const Mat& _image, const string& _face_cascade_path, 
         const string& _eye_cascade_path)
-    :image(_image), face_cascade_path(_face_cascade_path), eye_cascade_path(_eye_cascade_path)
+    :image(_image), face_cascade_path(_face_cascade_path), eye_cascade_path(_eye_cascade_path), ingest(NULL)
 {
-    face_cascade.load(face_cascade_path);
-    eye_cascade.load(eye_cascade_path);
+    loadCascades();
+}
+
+EyebrowROI::EyebrowROI(const Mat& _image, const string& _face_cascade_path, 
+        const string& _eye_cascade_path, const CascadeProfile& _cascade_profile)
+    :image(_image), face_cascade_path(_face_cascade_path), eye_cascade_path(_eye_cascade_path),
+    cascade_profile(_cascade_profile), ingest(NULL)
+{
+    loadCascades();
+}
+
+// Faces are found on the reduced decode of _ingest, eyes on full resolution face crops
+EyebrowROI::EyebrowROI(ImageIngest& _ingest, const string& _face_cascade_path,
+        const string& _eye_cascade_path, const CascadeProfile& _cascade_profile)
+    :face_cascade_path(_face_cascade_path), eye_cascade_path(_eye_cascade_path),
+    cascade_profile(_cascade_profile), ingest(&_ingest)
+{
+    loadCascades();
 }
 
 EyebrowROI::EyebrowROI(const EyebrowROI& _obj)
@@ -19,13 +35,58 @@ EyebrowROI::EyebrowROI(const EyebrowROI& _obj)
     image = _obj.image;
     face_cascade_path = _obj.face_cascade_path;
     eye_cascade_path = _obj.eye_cascade_path;
-    face_cascade = _obj.face_cascade;
+    face_detector = _obj.face_detector;
     eye_cascade = _obj.eye_cascade;
+    cascade_profile = _obj.cascade_profile;
+    ingest = _obj.ingest;
+    face_crops = _obj.face_crops;
+    load_error = _obj.load_error;
+}
+
+// Fails (see loadError()) on an unknown backend or a cascade of another feature type
+void EyebrowROI::loadCascades()
+{
+    face_detector = createFaceDetector(cascade_profile.getFaceDetector());
+    if(face_detector.empty() || !face_detector->load(face_cascade_path))
+    {
+        load_error = "Unable to load " + face_cascade_path + " as a " + cascade_profile.getFaceDetector()
+            + " face detector";
+        face_detector = Ptr<FaceDetector>();
+        return;
+    }
+    if(!eye_cascade.load(eye_cascade_path))
+        load_error = "Unable to load the eye cascade " + eye_cascade_path;
+    return;
+}
+
+bool EyebrowROI::isLoaded() const
+{
+    return load_error.empty();
+}
+
+string EyebrowROI::loadError() const
+{
+    return load_error;
 }
 
 void EyebrowROI::detectFace()
 {
-    face_cascade.detectMultiScale(image, faces, 1.15, 3, 0|CASCADE_SCALE_IMAGE, Size(30, 30));
+    if(!isLoaded())
+        return;
+
+    if(!ingest)
+    {
+        face_detector->detect(image, faces, cascade_profile.get("face"));
+        return;
+    }
+
+    // faces are reported in full resolution pixels either way, one per decoded crop
+    vector<Rect_<int> > reduced_faces;
+    face_detector->detect(ingest->detectionImage(), reduced_faces,
+            ingest->detectionParams(cascade_profile.get("face")));
+    face_crops = ingest->decodeFaceCrops(reduced_faces);
+    for(unsigned int i = 0; i < face_crops.size(); ++i)
+        faces.push_back(face_crops[i].face);
     return;
 }
 
@@ -35,9 +96,12 @@ void EyebrowROI::detectEyebrows()
     for(unsigned int i = 0; i < faces.size(); ++i)
     {
         Rect_<int> face = faces[i];
-        face_roi = image(Rect(face.x, face.y, face.width, face.height));
+        if(ingest)
+            face_roi = face_crops[i].image;
+        else
+            face_roi = image(Rect(face.x, face.y, face.width, face.height));
 
-        eye_cascade.detectMultiScale(face_roi, eyes, 1.20, 5, 0|CASCADE_SCALE_IMAGE, Size(30, 30));
+        runCascade(eye_cascade, face_roi, eyes, cascade_profile.get("eyes"));
     }
     return;
 }
@@ -5,6 +5,10 @@
 #include "opencv2/objdetect/objdetect.hpp"
 #include "opencv2/highgui/highgui.hpp"
 
+#include "cascade_profile.h"
+#include "face_detector.h"
+#include "image_ingest.h"
+
 using namespace std;
 using namespace cv;
 
@@ -14,9 +18,14 @@ class EyebrowROI
         Mat image;
         string face_cascade_path;
         string eye_cascade_path;
-        CascadeClassifier face_cascade;
+        Ptr<FaceDetector> face_detector;
         CascadeClassifier eye_cascade;
+        CascadeProfile cascade_profile;
+        ImageIngest* ingest;                    // reduced decode for the face cascade, if set
+        vector<FaceCrop> face_crops;            // full resolution faces decoded by ingest
+        string load_error;
 
+        void loadCascades();
 
     public:
         Mat face_roi;
@@ -26,7 +35,13 @@ class EyebrowROI
         
         EyebrowROI(const Mat& _image, const string& _face_cascade_path, 
                 const string& _eye_cascade_path);
+        EyebrowROI(const Mat& _image, const string& _face_cascade_path, 
+                const string& _eye_cascade_path, const CascadeProfile& _cascade_profile);
+        EyebrowROI(ImageIngest& _ingest, const string& _face_cascade_path,
+                const string& _eye_cascade_path, const CascadeProfile& _cascade_profile);
         EyebrowROI(const EyebrowROI& _obj);
+        bool isLoaded() const;
+        string loadError() const;
         void detectFace();
         void detectEyebrows();
         vector<Mat> displayROI();
@@ -10,8 +10,18 @@
 #include "opencv2/highgui/highgui.hpp"
 #include "opencv2/imgproc/imgproc.hpp"
 
+#include "cascade/cascade_profile.h"
+#include "cascade/face_detector.h"
+#include "cascade/tiled_detection.h"
+#include "cache/result_cache.h"
+#include "profiling/perf_profile.h"
+#include "motion/motion_gate.h"
+#include "ingest/image_ingest.h"
+
 #include <iostream>
 #include <cstdio>
+#include <cstdlib>
+#include <sstream>
 #include <vector>
 #include <algorithm>
 
@@ -25,14 +35,48 @@ static bool doesCmdOptionExist(const vector<string>& , const string&);
 
 // Functions for facial feature detection
 static void help();
-static void detectFaces(Mat&, vector<Rect_<int> >&, string);
+static void detectFaces(Mat&, vector<Rect_<int> >&, string, const CascadeParams&, const TilingParams&);
+static void detectFacesReduced(const Mat&, vector<Rect_<int> >&);
 static void detectEyes(Mat&, vector<Rect_<int> >&, string);
 static void detectNose(Mat&, vector<Rect_<int> >&, string);
 static void detectMouth(Mat&, vector<Rect_<int> >&, string);
-static void detectFacialFeaures(Mat&, const vector<Rect_<int> >, string, string, string);
+static void detectFacialFeaures(Mat&, const vector<Rect_<int> >, string, string, string, CachedResult&);
+static void drawFacialFeatures(Mat&, const CachedResult&);
+static string describeConfiguration();
+
+// Work done and saved by the motion gate in -video mode
+struct VideoStats
+{
+    int64 frames;
+    int64 faces_reused;
+    int64 faces_analysed;
+    int64 searched_pixels;
+    int64 frame_pixels;
+    double time_ms;
+
+    VideoStats()
+        :frames(0), faces_reused(0), faces_analysed(0), searched_pixels(0), frame_pixels(0), time_ms(0.0)
+    {
+    }
+};
+
+// Functions for streaming input
+static int processVideo(const string&, const vector<string>&);
+static void updateFacialFeatures(Mat&, const MotionGate&, CachedResult&, VideoStats&);
+
+// Margin in pixels added around the changed region before searching it for faces
+const int MOTION_SEARCH_MARGIN = 32;
 
 string input_image_path;
 string face_cascade_path, eye_cascade_path, nose_cascade_path, mouth_cascade_path;
+CascadeProfile cascade_profile;
+TilingParams tiling;
+int reduction = 1;
+
+// Detectors are loaded on first use and kept for every following image or frame
+Ptr<FaceDetector> face_detector;
+vector<Ptr<FaceDetector> > tile_detectors;
+CascadeClassifier eyes_classifier, nose_classifier, mouth_classifier;
 
 int main(int argc, char** argv)
 {
@@ -52,14 +96,71 @@ int main(int argc, char** argv)
     nose_cascade_path = (doesCmdOptionExist(args, "-nose")) ? getCommandOption(args, "-nose") : "";
     mouth_cascade_path = (doesCmdOptionExist(args, "-mouth")) ? getCommandOption(args, "-mouth") : "";
 
+    // Load detectMultiScale() parameters if a tuning profile is provided
+    if(doesCmdOptionExist(args, "-profile") && !cascade_profile.load(getCommandOption(args, "-profile")))
+    {
+        cout << "Unable to read the tuning profile " << getCommandOption(args, "-profile") << "\n";
+        return 1;
+    }
+    if(doesCmdOptionExist(args, "-detector"))
+        cascade_profile.setFaceDetector(getCommandOption(args, "-detector"));
+
+    // Large images are searched tile by tile for faces up to the given size
+    if(doesCmdOptionExist(args, "-tile"))
+        tiling.max_face = atoi(getCommandOption(args, "-tile").c_str());
+    if(doesCmdOptionExist(args, "-tile-budget"))
+        tiling.memory_budget = (size_t)atoi(getCommandOption(args, "-tile-budget").c_str()) << 20;
+
+    // -reduce N searches faces on a 1/N grayscale copy of the image
+    if(doesCmdOptionExist(args, "-reduce"))
+    {
+        reduction = atoi(getCommandOption(args, "-reduce").c_str());
+        if(!isReductionSupported(reduction))
+        {
+            cout << "-reduce takes 2, 4 or 8\n";
+            return 1;
+        }
+    }
+
+    // -perf counts cycles, instructions and cache/branch misses of each detectMultiScale() stage
+    if(doesCmdOptionExist(args, "-perf"))
+        perfProfiler().enable();
+
+    // -video processes a video file or camera, rerunning detection only where the frames change
+    if(doesCmdOptionExist(args, "-video"))
+        return processVideo(input_image_path, args);
+
+    // -cache answers repeated images from a result store on disk. One image is handled per run,
+    // so the in-memory LRU only holds this result; the key is not computed without -cache.
+    bool use_cache = doesCmdOptionExist(args, "-cache");
+    ResultCache result_cache(1);
+    if(use_cache && !result_cache.openStore(getCommandOption(args, "-cache"), 4096))
+        cout << "Unable to open the result cache " << getCommandOption(args, "-cache") << "\n";
+
     // Load image and cascade classifier files
     Mat image;
     image = imread(input_image_path);
 
     // Detect faces and facial features
-    vector<Rect_<int> > faces;
-    detectFaces(image, faces, face_cascade_path);
-    detectFacialFeaures(image, faces, eye_cascade_path, nose_cascade_path, mouth_cascade_path);
+    CachedResult features;
+    uint64 key = use_cache ? cacheKey(image, describeConfiguration()) : 0;
+    if(!use_cache || !result_cache.lookup(key, features))
+    {
+        vector<Rect_<int> > faces;
+        if(reduction > 1)
+            detectFacesReduced(image, faces);
+        else
+            detectFaces(image, faces, face_cascade_path, cascade_profile.get("face"), tiling);
+        detectFacialFeaures(image, faces, eye_cascade_path, nose_cascade_path, mouth_cascade_path, features);
+        if(use_cache)
+            result_cache.insert(key, features);
+    }
+    drawFacialFeatures(image, features);
+
+    if(use_cache)
+        result_cache.printStats();
+    if(perfProfiler().isEnabled())
+        perfProfiler().printReport();
 
     imshow("Result", image);
 
@@ -99,13 +200,22 @@ static void help()
         "to give reasonably accurate results. \n";
 
     cout << "\nUSAGE: ./cpp-example-facial_features [IMAGE] [FACE_CASCADE] [OPTIONS]\n"
-        "IMAGE\n\tPath to the image of a face taken as input.\n"
-        "FACE_CASCSDE\n\t Path to a haarcascade classifier for face detection.\n"
-        "OPTIONS: \nThere are 3 options available which are described in detail. There must be a "
-        "space between the option and it's argument (All three options accept arguments).\n"
+        "IMAGE\n\tPath to the image of a face taken as input (with -video, a video file or camera index).\n"
+        "FACE_CASCSDE\n\t Path to a haarcascade (or, with -detector lbp, lbpcascade) classifier for face detection.\n"
+        "OPTIONS: \nThere are 12 options available which are described in detail. There must be a "
+        "space between the option and it's argument (All options except -perf and -video accept arguments).\n"
         "\t-eyes : Specify the haarcascade classifier for eye detection.\n"
         "\t-nose : Specify the haarcascade classifier for nose detection.\n"
-        "\t-mouth : Specify the haarcascade classifier for mouth detection.\n";
+        "\t-mouth : Specify the haarcascade classifier for mouth detection.\n"
+        "\t-profile : Specify a tuning profile with the detection parameters of each cascade.\n"
+        "\t-detector : Face detection backend, haar (default) or lbp. FACE_CASCADE must match it.\n"
+        "\t-tile : Detect faces tile by tile, for faces up to the given size in pixels (large images).\n"
+        "\t-tile-budget : Memory in MB shared by the tiles processed in parallel (default: 512).\n"
+        "\t-cache : Specify a file in which results are cached across runs, keyed by image content.\n"
+        "\t-perf : Print per-stage time, IPC and bytes/pixel from the hardware performance counters.\n"
+        "\t-reduce : Detect faces on a 1/N (2, 4 or 8) grayscale copy, the features on the full image.\n"
+        "\t-video : Treat IMAGE as a video, faces whose region did not change keep their features.\n"
+        "\t-motion-threshold : Mean gray-level difference of a 16x16 block that counts as change (default: 8).\n";
 
 
     cout << "EXAMPLE:\n"
@@ -114,7 +224,11 @@ static void help()
         "(2) ./cpp-example-facial_features image.jpg face.xml -nose nose.xml\n"
         "\tThis will detect the face and nose in image.jpg.\n"
         "(3) ./cpp-example-facial_features image.jpg face.xml\n"
-        "\tThis will detect only the face in image.jpg.\n";
+        "\tThis will detect only the face in image.jpg.\n"
+        "(4) ./cpp-example-facial_features panorama.jpg face.xml -tile 400 -tile-budget 256\n"
+        "\tThis will detect faces up to 400x400 pixels in panorama.jpg using at most 256 MB for the tiles.\n"
+        "(5) ./cpp-example-facial_features 0 face.xml -eyes eyes.xml -video\n"
+        "\tThis will detect the face and eyes in the stream of camera 0, rerunning only on faces that moved.\n";
 
     cout << " \n\nThe classifiers for face and eyes can be downloaded from : "
         " \nhttps://github.com/Itseez/opencv/tree/master/data/haarcascades";
@@ -123,24 +237,80 @@ static void help()
         " \nhttps://github.com/Itseez/opencv_contrib/tree/master/modules/face/data/cascades\n";
 }
 
-static void detectFaces(Mat& img, vector<Rect_<int> >& faces, string cascade_path)
+static void detectFaces(Mat& img, vector<Rect_<int> >& faces, string cascade_path, const CascadeParams& params,
+        const TilingParams& face_tiling)
 {
-    CascadeClassifier face_cascade;
-    face_cascade.load(cascade_path);
+    if(face_tiling.max_face > 0)
+    {
+        // Only detectors missing from the pool are loaded, i.e. at most once per worker
+        if(!loadDetectors(cascade_profile.getFaceDetector(), cascade_path, tileWorkers(img.size(), face_tiling),
+                    tile_detectors) && tile_detectors.empty())
+        {
+            cout << "Unable to load " << cascade_path << " as a " << cascade_profile.getFaceDetector()
+                << " face detector\n";
+            return;
+        }
+        detectTiled(tile_detectors, img, faces, params, face_tiling);
+        return;
+    }
 
-    face_cascade.detectMultiScale(img, faces, 1.15, 3, 0|CASCADE_SCALE_IMAGE, Size(30, 30));
+    if(face_detector.empty())
+    {
+        face_detector = createFaceDetector(cascade_profile.getFaceDetector());
+        if(face_detector.empty() || !face_detector->load(cascade_path))
+        {
+            cout << "Unable to load " << cascade_path << " as a " << cascade_profile.getFaceDetector()
+                << " face detector\n";
+            face_detector = Ptr<FaceDetector>();
+            return;
+        }
+    }
+
+    face_detector->detect(img, faces, params);
+    return;
+}
+
+/*
+ * Detect faces on a 1/reduction grayscale copy of image and map them back
+ * onto image. main() needs the full image for the features and the
+ * drawing, so the copy is downscaled from it rather than decoded a second
+ * time; the face cascade, the most expensive stage, runs on the small
+ * image only.
+ */
+static void detectFacesReduced(const Mat& image, vector<Rect_<int> >& faces)
+{
+    ImageIngest ingest(image, reduction);
+    Mat reduced_image = ingest.detectionImage();
+
+    TilingParams reduced_tiling = tiling;
+    reduced_tiling.max_face = tiling.max_face / reduction;
+
+    vector<Rect_<int> > reduced_faces;
+    detectFaces(reduced_image, reduced_faces, face_cascade_path, ingest.detectionParams(cascade_profile.get("face")),
+            reduced_tiling);
+
+    Rect_<int> bounds(0, 0, image.cols, image.rows);
+    for(unsigned int i = 0; i < reduced_faces.size(); ++i)
+    {
+        Rect_<int> face = ingest.toFullResolution(reduced_faces[i]) & bounds;
+        if(face.area() > 0)
+            faces.push_back(face);
+    }
     return;
 }
 
+/*
+ * Detect eyes, nose and mouth inside every face. For each face, result gets
+ * the number of eyes, noses and mouths found in counts, and the face
+ * followed by those eyes, noses and mouths in rects.
+ */
 static void detectFacialFeaures(Mat& img, const vector<Rect_<int> > faces, string eye_cascade,
-        string nose_cascade, string mouth_cascade)
+        string nose_cascade, string mouth_cascade, CachedResult& result)
 {
     for(unsigned int i = 0; i < faces.size(); ++i)
     {
-        // Mark the bounding box enclosing the face
         Rect face = faces[i];
-        rectangle(img, Point(face.x, face.y), Point(face.x+face.width, face.y+face.height),
-                Scalar(255, 0, 0), 1, 4);
+        result.rects.push_back(face);
 
         // Eyes, nose and mouth will be detected inside the face (region of interest)
         Mat ROI = img(Rect(face.x, face.y, face.width, face.height));
@@ -151,39 +321,26 @@ static void detectFacialFeaures(Mat& img, const vector<Rect_<int> > faces, strin
             is_full_detection = true;
 
         // Detect eyes if classifier provided by the user
+        vector<Rect_<int> > eyes;
         if(!eye_cascade.empty())
-        {
-            vector<Rect_<int> > eyes;
             detectEyes(ROI, eyes, eye_cascade);
-
-            // Mark points corresponding to the centre of the eyes
-            for(unsigned int j = 0; j < eyes.size(); ++j)
-            {
-                Rect e = eyes[j];
-                circle(ROI, Point(e.x+e.width/2, e.y+e.height/2), 3, Scalar(0, 255, 0), -1, 8);
-                /* rectangle(ROI, Point(e.x, e.y), Point(e.x+e.width, e.y+e.height),
-                    Scalar(0, 255, 0), 1, 4); */
-            }
-        }
+        result.counts.push_back(eyes.size());
+        result.rects.insert(result.rects.end(), eyes.begin(), eyes.end());
 
         // Detect nose if classifier provided by the user
         double nose_center_height = 0.0;
+        vector<Rect_<int> > nose;
         if(!nose_cascade.empty())
         {
-            vector<Rect_<int> > nose;
             detectNose(ROI, nose, nose_cascade);
-
-            // Mark points corresponding to the centre (tip) of the nose
             for(unsigned int j = 0; j < nose.size(); ++j)
-            {
-                Rect n = nose[j];
-                circle(ROI, Point(n.x+n.width/2, n.y+n.height/2), 3, Scalar(0, 255, 0), -1, 8);
-                nose_center_height = (n.y + n.height/2);
-            }
+                nose_center_height = (nose[j].y + nose[j].height/2);
         }
+        result.counts.push_back(nose.size());
+        result.rects.insert(result.rects.end(), nose.begin(), nose.end());
 
         // Detect mouth if classifier provided by the user
-        double mouth_center_height = 0.0;
+        vector<Rect_<int> > mouth_kept;
         if(!mouth_cascade.empty())
         {
             vector<Rect_<int> > mouth;
@@ -192,48 +349,210 @@ static void detectFacialFeaures(Mat& img, const vector<Rect_<int> > faces, strin
             for(unsigned int j = 0; j < mouth.size(); ++j)
             {
                 Rect m = mouth[j];
-                mouth_center_height = (m.y + m.height/2);
+                double mouth_center_height = (m.y + m.height/2);
 
                 // The mouth should lie below the nose
-                if( (is_full_detection) && (mouth_center_height > nose_center_height) )
-                {
-                    rectangle(ROI, Point(m.x, m.y), Point(m.x+m.width, m.y+m.height), Scalar(0, 255, 0), 1, 4);
-                }
-                else if( (is_full_detection) && (mouth_center_height <= nose_center_height) )
+                if( (is_full_detection) && (mouth_center_height <= nose_center_height) )
                     continue;
-                else
-                    rectangle(ROI, Point(m.x, m.y), Point(m.x+m.width, m.y+m.height), Scalar(0, 255, 0), 1, 4);
+                mouth_kept.push_back(m);
             }
         }
+        result.counts.push_back(mouth_kept.size());
+        result.rects.insert(result.rects.end(), mouth_kept.begin(), mouth_kept.end());
+    }
+
+    return;
+}
+
+static void drawFacialFeatures(Mat& img, const CachedResult& result)
+{
+    unsigned int r = 0;
+    for(unsigned int i = 0; i + 2 < result.counts.size(); i += 3)
+    {
+        // Mark the bounding box enclosing the face
+        Rect face = result.rects[r++];
+        rectangle(img, Point(face.x, face.y), Point(face.x+face.width, face.y+face.height),
+                Scalar(255, 0, 0), 1, 4);
+        Mat ROI = img(Rect(face.x, face.y, face.width, face.height));
+
+        // Mark points corresponding to the centre of the eyes
+        for(int j = 0; j < result.counts[i]; ++j)
+        {
+            Rect e = result.rects[r++];
+            circle(ROI, Point(e.x+e.width/2, e.y+e.height/2), 3, Scalar(0, 255, 0), -1, 8);
+        }
 
+        // Mark points corresponding to the centre (tip) of the nose
+        for(int j = 0; j < result.counts[i+1]; ++j)
+        {
+            Rect n = result.rects[r++];
+            circle(ROI, Point(n.x+n.width/2, n.y+n.height/2), 3, Scalar(0, 255, 0), -1, 8);
+        }
+
+        for(int j = 0; j < result.counts[i+2]; ++j)
+        {
+            Rect m = result.rects[r++];
+            rectangle(ROI, Point(m.x, m.y), Point(m.x+m.width, m.y+m.height), Scalar(0, 255, 0), 1, 4);
+        }
     }
 
     return;
 }
 
+// Everything besides the pixels that the detection result depends on
+static string describeConfiguration()
+{
+    ostringstream config;
+    const char* cascade_names[] = { "face", "eyes", "nose", "mouth" };
+    const string cascade_paths[] = { face_cascade_path, eye_cascade_path, nose_cascade_path, mouth_cascade_path };
+
+    // The cascades enter by content, so a replaced file does not serve stale results
+    config << cascade_profile.getFaceDetector();
+    for(int i = 0; i < 4; ++i)
+        config << ";" << cascade_paths[i] << "#" << hashFile(cascade_paths[i]);
+    config << ";" << tiling.max_face << ";" << reduction;
+    for(int i = 0; i < 4; ++i)
+    {
+        CascadeParams p = cascade_profile.get(cascade_names[i]);
+        config << ";" << p.scale_factor << "," << p.min_neighbors << "," << p.min_size.width << "x"
+            << p.min_size.height << "," << p.max_size.width << "x" << p.max_size.height;
+    }
+    return config.str();
+}
+
 static void detectEyes(Mat& img, vector<Rect_<int> >& eyes, string cascade_path)
 {
-    CascadeClassifier eyes_cascade;
-    eyes_cascade.load(cascade_path);
+    if(eyes_classifier.empty())
+        eyes_classifier.load(cascade_path);
 
-    eyes_cascade.detectMultiScale(img, eyes, 1.20, 5, 0|CASCADE_SCALE_IMAGE, Size(30, 30));
+    runCascade(eyes_classifier, img, eyes, cascade_profile.get("eyes"));
     return;
 }
 
 static void detectNose(Mat& img, vector<Rect_<int> >& nose, string cascade_path)
 {
-    CascadeClassifier nose_cascade;
-    nose_cascade.load(cascade_path);
+    if(nose_classifier.empty())
+        nose_classifier.load(cascade_path);
 
-    nose_cascade.detectMultiScale(img, nose, 1.20, 5, 0|CASCADE_SCALE_IMAGE, Size(30, 30));
+    runCascade(nose_classifier, img, nose, cascade_profile.get("nose"));
     return;
 }
 
 static void detectMouth(Mat& img, vector<Rect_<int> >& mouth, string cascade_path)
 {
-    CascadeClassifier mouth_cascade;
-    mouth_cascade.load(cascade_path);
+    if(mouth_classifier.empty())
+        mouth_classifier.load(cascade_path);
+
+    runCascade(mouth_classifier, img, mouth, cascade_profile.get("mouth"));
+    return;
+}
+
+/*
+ * Runs the detection on every frame of a video file or camera (numeric
+ * SOURCE). The motion gate decides which faces still hold from the last
+ * frame; skipped frames, reused faces and the searched area are reported
+ * at the end.
+ */
+static int processVideo(const string& source, const vector<string>& args)
+{
+    VideoCapture capture;
+    bool is_camera = !source.empty() && (source.find_first_not_of("0123456789") == string::npos);
+    if(is_camera ? !capture.open(atoi(source.c_str())) : !capture.open(source))
+    {
+        cout << "Unable to open the video " << source << "\n";
+        return 1;
+    }
+
+    MotionParams motion_params;
+    if(doesCmdOptionExist(args, "-motion-threshold"))
+        motion_params.threshold = atoi(getCommandOption(args, "-motion-threshold").c_str());
+    MotionGate motion_gate(motion_params);
+
+    VideoStats stats;
+    CachedResult features;
+    Mat frame;
+    while(capture.read(frame))
+    {
+        int64 frame_start = getTickCount();
+        if(motion_gate.update(frame))
+            updateFacialFeatures(frame, motion_gate, features, stats);
+        else
+            stats.faces_reused += features.counts.size() / 3;      // nothing changed, every face is kept
+        stats.time_ms += (getTickCount() - frame_start) * 1000.0 / getTickFrequency();
+        stats.frames++;
+        stats.frame_pixels += frame.total();
+
+        drawFacialFeatures(frame, features);
+        imshow("Result", frame);
+        if(waitKey(1) >= 0)
+            break;
+    }
+
+    motion_gate.printStats();
+    double searched_ratio = (stats.frame_pixels > 0) ? 100.0 * stats.searched_pixels / stats.frame_pixels : 0.0;
+    double frame_ms = (stats.frames > 0) ? stats.time_ms / stats.frames : 0.0;
+    cout << "Faces: " << stats.faces_reused << " reused, " << stats.faces_analysed << " analysed, face search over "
+        << searched_ratio << "% of the frame area, " << frame_ms << " ms per frame\n";
+    if(perfProfiler().isEnabled())
+        perfProfiler().printReport();
+    return 0;
+}
+
+/*
+ * Brings features up to date with frame. Faces whose blocks are all
+ * static keep their rects and features. The others are dropped, and faces
+ * are searched for again in the changed region grown by those faces; only
+ * the faces found there are analysed.
+ */
+static void updateFacialFeatures(Mat& frame, const MotionGate& motion_gate, CachedResult& features, VideoStats& stats)
+{
+    CachedResult updated;
+    vector<Rect_<int> > kept_faces;
+    Rect_<int> search = motion_gate.changedRegion();
+
+    unsigned int r = 0;
+    for(unsigned int i = 0; i + 2 < features.counts.size(); i += 3)
+    {
+        int n_rects = 1 + features.counts[i] + features.counts[i+1] + features.counts[i+2];
+        Rect_<int> face = features.rects[r];
+        if(motion_gate.isStatic(face))
+        {
+            updated.counts.insert(updated.counts.end(), features.counts.begin() + i, features.counts.begin() + i + 3);
+            updated.rects.insert(updated.rects.end(), features.rects.begin() + r, features.rects.begin() + r + n_rects);
+            kept_faces.push_back(face);
+            stats.faces_reused++;
+        }
+        else
+            search = (search.area() > 0) ? (search | face) : face;
+        r += n_rects;
+    }
+
+    if(search.area() > 0)
+    {
+        search = Rect_<int>(search.x - MOTION_SEARCH_MARGIN, search.y - MOTION_SEARCH_MARGIN,
+                search.width + 2 * MOTION_SEARCH_MARGIN, search.height + 2 * MOTION_SEARCH_MARGIN)
+            & Rect_<int>(0, 0, frame.cols, frame.rows);
+
+        Mat region = frame(search);
+        vector<Rect_<int> > found, faces;
+        detectFaces(region, found, face_cascade_path, cascade_profile.get("face"), tiling);
+        for(unsigned int i = 0; i < found.size(); ++i)
+        {
+            Rect_<int> face(found[i].x + search.x, found[i].y + search.y, found[i].width, found[i].height);
+
+            // A static face reaching into the search region is found again
+            bool is_kept = false;
+            for(unsigned int j = 0; j < kept_faces.size() && !is_kept; ++j)
+                is_kept = (overlapRatio(face, kept_faces[j]) > 0.3);
+            if(!is_kept)
+                faces.push_back(face);
+        }
+
+        detectFacialFeaures(frame, faces, eye_cascade_path, nose_cascade_path, mouth_cascade_path, updated);
+        stats.faces_analysed += faces.size();
+        stats.searched_pixels += search.area();
+    }
 
-    mouth_cascade.detectMultiScale(img, mouth, 1.20, 5, 0|CASCADE_SCALE_IMAGE, Size(30, 30));
+    features = updated;
     return;
 }
@@ -0,0 +1,297 @@
+#ifndef _IMAGE_INGEST_CPP
+#define _IMAGE_INGEST_CPP
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "image_ingest.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// Band decoding needs jpeg_skip_scanlines() and jpeg_crop_scanline() of libjpeg-turbo 1.5 or later
+#if defined(HAVE_JPEG)
+#include <csetjmp>
+#include <jpeglib.h>
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER) && (LIBJPEG_TURBO_VERSION_NUMBER >= 1005000)
+#define INGEST_BAND_DECODE
+#endif
+#endif
+
+using namespace std;
+using namespace cv;
+
+ImageIngest::ImageIngest(const string& _image_path, int _reduction)
+    :image_path(_image_path), reduction(_reduction), decode_time(0.0)
+{
+    if(reduction != 2 && reduction != 4 && reduction != 8)
+        reduction = 1;
+}
+
+ImageIngest::ImageIngest(const Mat& _image, int _reduction)
+    :image(_image), reduction(_reduction), decode_time(0.0)
+{
+    if(reduction != 2 && reduction != 4 && reduction != 8)
+        reduction = 1;
+}
+
+/*
+ * Grayscale image at 1/reduction of the original size, decoded on first
+ * use (or downscaled from the decoded image the ingest was built from)
+ */
+const Mat& ImageIngest::detectionImage()
+{
+    if(detection_image.empty() && !image.empty())
+    {
+        Mat gray;
+        if(image.channels() == 3)
+            cvtColor(image, gray, CV_BGR2GRAY);
+        else
+            gray = image;
+        if(reduction > 1)
+            resize(gray, detection_image, Size(), 1.0 / reduction, 1.0 / reduction, INTER_AREA);
+        else
+            detection_image = gray;
+    }
+    else if(detection_image.empty())
+    {
+        int64 start = getTickCount();
+        detection_image = imread(image_path, reducedGrayscaleFlag(reduction));
+        decode_time += (getTickCount() - start) * 1000.0 / getTickFrequency();
+    }
+    return detection_image;
+}
+
+int ImageIngest::getReduction() const
+{
+    return reduction;
+}
+
+// Object sizes are given in full resolution pixels and shrink with the image
+CascadeParams ImageIngest::detectionParams(const CascadeParams& params) const
+{
+    CascadeParams reduced = params;
+    reduced.min_size = Size(params.min_size.width / reduction, params.min_size.height / reduction);
+    reduced.max_size = Size(params.max_size.width / reduction, params.max_size.height / reduction);
+    return reduced;
+}
+
+Rect_<int> ImageIngest::toFullResolution(const Rect_<int>& rect) const
+{
+    return Rect(rect.x * reduction, rect.y * reduction, rect.width * reduction, rect.height * reduction);
+}
+
+#if defined(INGEST_BAND_DECODE)
+struct JpegError
+{
+    struct jpeg_error_mgr manager;
+    jmp_buf jump;
+};
+
+static void exitJpeg(j_common_ptr cinfo)
+{
+    longjmp(((JpegError*)cinfo->err)->jump, 1);
+}
+
+static unsigned readExifWord(const JOCTET* data, bool little_endian, int bytes)
+{
+    unsigned value = 0;
+    for(int k = 0; k < bytes; ++k)
+        value |= (unsigned)data[little_endian ? k : (bytes - 1 - k)] << (8 * k);
+    return value;
+}
+
+// Orientation tag of the EXIF (APP1) marker, 1 (upright) if there is none
+static int exifOrientation(jpeg_saved_marker_ptr marker)
+{
+    for(; marker; marker = marker->next)
+    {
+        if(marker->marker != JPEG_APP0 + 1 || marker->data_length < 14 || memcmp(marker->data, "Exif\0\0", 6) != 0)
+            continue;
+
+        const JOCTET* tiff = marker->data + 6;
+        const unsigned length = marker->data_length - 6;
+        const bool little_endian = (tiff[0] == 'I');
+        unsigned ifd = readExifWord(tiff + 4, little_endian, 4);
+        if(ifd + 2 > length)
+            return 1;
+        unsigned entries = readExifWord(tiff + ifd, little_endian, 2);
+        for(unsigned i = 0; i < entries && ifd + 2 + 12 * (i + 1) <= length; ++i)
+        {
+            const JOCTET* entry = tiff + ifd + 2 + 12 * i;
+            if(readExifWord(entry, little_endian, 2) == 0x0112)
+                return (int)readExifWord(entry + 8, little_endian, 2);
+        }
+    }
+    return 1;
+}
+
+/*
+ * Decode the rows of region (in full resolution pixels) of a JPEG file to
+ * BGR. The rows above region are skipped without colour conversion or
+ * upsampling, the rows below are not decoded at all, and the columns are
+ * cropped to the iMCU columns covering region (plus one on either side). band receives the decoded
+ * pixels and band_rect their position in the image. Returns false for
+ * files libjpeg cannot read, CMYK files and files with an EXIF
+ * orientation (which imread() applies), so that the caller can fall back
+ * to a full decode. band is owned by the caller, so nothing needs to be
+ * destroyed when libjpeg jumps back on an error.
+ */
+static bool decodeJpegBand(const string& path, const Rect_<int>& region, Mat& band, Rect_<int>& band_rect)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if(!file)
+        return false;
+
+    struct jpeg_decompress_struct cinfo;
+    JpegError error;
+    cinfo.err = jpeg_std_error(&error.manager);
+    error.manager.error_exit = exitJpeg;
+    if(setjmp(error.jump))
+    {
+        jpeg_destroy_decompress(&cinfo);
+        fclose(file);
+        return false;
+    }
+
+    jpeg_create_decompress(&cinfo);
+    jpeg_stdio_src(&cinfo, file);
+    jpeg_save_markers(&cinfo, JPEG_APP0 + 1, 0xFFFF);
+    jpeg_read_header(&cinfo, TRUE);
+
+    Rect_<int> rows = region & Rect_<int>(0, 0, cinfo.image_width, cinfo.image_height);
+    if(rows.area() == 0 || exifOrientation(cinfo.marker_list) != 1 ||
+            (cinfo.jpeg_color_space != JCS_YCbCr && cinfo.jpeg_color_space != JCS_GRAYSCALE))
+    {
+        jpeg_destroy_decompress(&cinfo);
+        fclose(file);
+        return false;
+    }
+
+    cinfo.out_color_space = JCS_EXT_BGR;
+    jpeg_start_decompress(&cinfo);
+
+    // One more iMCU column on either side, so that the chroma upsampling at the edges of
+    // region sees the same neighbours as in a full decode
+    int margin = cinfo.max_h_samp_factor * DCTSIZE;
+    int x0 = max(rows.x - margin, 0), x1 = min(rows.x + rows.width + margin, (int)cinfo.image_width);
+    JDIMENSION x_offset = x0, width = x1 - x0;
+    jpeg_crop_scanline(&cinfo, &x_offset, &width);
+    jpeg_skip_scanlines(&cinfo, rows.y);
+
+    band.create(rows.height, width, CV_8UC3);
+    while(cinfo.output_scanline < (JDIMENSION)(rows.y + rows.height))
+    {
+        JSAMPROW row = band.ptr(cinfo.output_scanline - rows.y);
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+
+    // The rows below the band are left undecoded
+    jpeg_abort_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    fclose(file);
+
+    band_rect = Rect_<int>(x_offset, rows.y, width, rows.height);
+    return true;
+}
+#endif
+
+/*
+ * Decode the given faces (in detection image coordinates) at full
+ * resolution. Only the band of rows and columns spanning the faces is
+ * decoded where libjpeg-turbo is available (HAVE_JPEG), otherwise the
+ * full image is decoded once and released again after the crops are
+ * copied out. Faces outside the image are dropped, so every crop carries
+ * its own face rect.
+ */
+vector<FaceCrop> ImageIngest::decodeFaceCrops(const vector<Rect_<int> >& faces)
+{
+    vector<FaceCrop> crops;
+    if(faces.empty())
+        return crops;
+
+    Rect_<int> region = toFullResolution(faces[0]);
+    for(unsigned int i = 1; i < faces.size(); ++i)
+        region |= toFullResolution(faces[i]);
+
+    Mat band;
+    Rect_<int> band_rect;
+    if(!image.empty())
+    {
+        band = image;
+        band_rect = Rect_<int>(0, 0, image.cols, image.rows);
+    }
+    else
+    {
+        int64 start = getTickCount();
+        bool band_decoded = false;
+#if defined(INGEST_BAND_DECODE)
+        band_decoded = decodeJpegBand(image_path, region, band, band_rect);
+#endif
+        if(!band_decoded)
+        {
+            band = imread(image_path);
+            band_rect = Rect_<int>(0, 0, band.cols, band.rows);
+        }
+        decode_time += (getTickCount() - start) * 1000.0 / getTickFrequency();
+    }
+
+    for(unsigned int i = 0; i < faces.size(); ++i)
+    {
+        FaceCrop crop;
+        crop.face = toFullResolution(faces[i]) & band_rect;
+        if(crop.face.area() == 0)
+            continue;
+        crop.image = band(Rect_<int>(crop.face.x - band_rect.x, crop.face.y - band_rect.y, crop.face.width,
+                    crop.face.height)).clone();
+        crops.push_back(crop);
+    }
+    return crops;
+}
+
+// Time spent decoding so far, in milliseconds
+double ImageIngest::decodeTime() const
+{
+    return decode_time;
+}
+
+// Reductions the JPEG decoder can apply while decoding
+bool isReductionSupported(int reduction)
+{
+    return (reduction == 1 || reduction == 2 || reduction == 4 || reduction == 8);
+}
+
+int reducedGrayscaleFlag(int reduction)
+{
+    switch(reduction)
+    {
+        case 2:
+            return IMREAD_REDUCED_GRAYSCALE_2;
+        case 4:
+            return IMREAD_REDUCED_GRAYSCALE_4;
+        case 8:
+            return IMREAD_REDUCED_GRAYSCALE_8;
+        default:
+            return IMREAD_GRAYSCALE;
+    }
+}
+
+// Peak resident set size of the process in KB, or -1 where unavailable
+long peakResidentKB()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return -1;
+#endif
+}
+
+#endif
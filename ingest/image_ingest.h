@@ -0,0 +1,51 @@
+#ifndef _IMAGE_INGEST_H
+#define _IMAGE_INGEST_H
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+#include "cascade_profile.h"
+
+using namespace std;
+using namespace cv;
+
+// Full resolution face (in image coordinates) and its pixels
+struct FaceCrop
+{
+    Rect_<int> face;
+    Mat image;
+};
+
+/*
+ * Two-stage image loading: a reduced grayscale decode (JPEG DCT-domain
+ * downscaling by 2, 4 or 8) for the face cascade, followed by a full
+ * resolution decode of only the rows and columns of the faces the
+ * feature kernels need. An ingest built from an already decoded image
+ * downscales that image instead and crops from it.
+ */
+class ImageIngest
+{
+    private:
+        string image_path;
+        Mat image;                              // set if constructed from a decoded image
+        int reduction;
+        Mat detection_image;
+        double decode_time;
+
+    public:
+        ImageIngest(const string& _image_path, int _reduction);
+        ImageIngest(const Mat& _image, int _reduction);
+        const Mat& detectionImage();
+        int getReduction() const;
+        CascadeParams detectionParams(const CascadeParams& params) const;
+        Rect_<int> toFullResolution(const Rect_<int>& rect) const;
+        vector<FaceCrop> decodeFaceCrops(const vector<Rect_<int> >& faces);
+        double decodeTime() const;
+};
+
+bool isReductionSupported(int reduction);
+int reducedGrayscaleFlag(int reduction);
+long peakResidentKB();
+
+#endif
@@ -0,0 +1,388 @@
+#ifndef _PIXEL_KERNELS_H
+#define _PIXEL_KERNELS_H
+
+#include <cmath>
+#include <cfloat>
+#include <climits>
+#include <limits>
+#include "opencv2/core/core.hpp"
+
+#include "histogram_threshold.h"
+
+using namespace std;
+using namespace cv;
+
+/*
+ * Colour kernels of the eyebrow and mouth pipelines, specialised at
+ * compile time on the input layout and the output depth. Each kernel
+ * reads the native frame through row pointers, so RGB, BGRA and NV12
+ * frames from decoders and cameras need no conversion pass.
+ *
+ * Packed layouts take a CV_8UC3/CV_8UC4 frame. NV12 takes the usual
+ * OpenCV single-channel frame of (rows * 3/2) x cols: the Y plane
+ * followed by the interleaved, half resolution U/V plane.
+ */
+
+// Channel positions of the packed layouts
+struct LayoutBGR
+{
+    enum { channels = 3, b = 0, g = 1, r = 2 };
+};
+
+struct LayoutRGB
+{
+    enum { channels = 3, b = 2, g = 1, r = 0 };
+};
+
+struct LayoutBGRA
+{
+    enum { channels = 4, b = 0, g = 1, r = 2 };
+};
+
+struct LayoutNV12
+{
+};
+
+// Row-wise access to the B, G and R values of a frame
+template<class Layout>
+class PixelReader
+{
+    private:
+        const Mat& frame;
+        const uchar* row;
+
+    public:
+        PixelReader(const Mat& _frame)
+            :frame(_frame), row(NULL)
+        {
+            CV_Assert(frame.type() == CV_8UC(Layout::channels));
+        }
+
+        int rows() const
+        {
+            return frame.rows;
+        }
+
+        int cols() const
+        {
+            return frame.cols;
+        }
+
+        void setRow(int i)
+        {
+            row = frame.ptr(i);
+        }
+
+        void read(int j, int& B, int& G, int& R) const
+        {
+            const uchar* pixel = row + j * Layout::channels;
+            B = pixel[Layout::b];
+            G = pixel[Layout::g];
+            R = pixel[Layout::r];
+        }
+};
+
+/*
+ * NV12 is converted per pixel with the fixed-point BT.601 coefficients of
+ * CV_YUV2BGR_NV12, so the kernels see the same B, G and R values as after
+ * a cvtColor() pass.
+ */
+template<>
+class PixelReader<LayoutNV12>
+{
+    private:
+        const Mat& frame;
+        const uchar* y_row;
+        const uchar* uv_row;
+
+        static inline int clampByte(int value)
+        {
+            return (value < 0) ? 0 : ((value > 255) ? 255 : value);
+        }
+
+    public:
+        PixelReader(const Mat& _frame)
+            :frame(_frame), y_row(NULL), uv_row(NULL)
+        {
+            // Whole Y and U/V planes, with an even number of luma rows and columns
+            CV_Assert(frame.type() == CV_8UC1 && frame.rows % 3 == 0 && (frame.rows * 2 / 3) % 2 == 0 &&
+                    frame.cols % 2 == 0);
+        }
+
+        int rows() const
+        {
+            return frame.rows * 2 / 3;
+        }
+
+        int cols() const
+        {
+            return frame.cols;
+        }
+
+        void setRow(int i)
+        {
+            y_row = frame.ptr(i);
+            uv_row = frame.ptr(rows() + i / 2);
+        }
+
+        void read(int j, int& B, int& G, int& R) const
+        {
+            const int CY = 1220542, CUB = 2116026, CUG = -409993, CVG = -852492, CVR = 1673527;
+            const int SHIFT = 20, HALF = 1 << (SHIFT - 1);
+
+            int u = int(uv_row[j & ~1]) - 128;
+            int v = int(uv_row[(j & ~1) + 1]) - 128;
+            int y = max(0, int(y_row[j]) - 16) * CY;
+            R = clampByte((y + HALF + CVR * v) >> SHIFT);
+            G = clampByte((y + HALF + CVG * v + CUG * u) >> SHIFT);
+            B = clampByte((y + HALF + CUB * u) >> SHIFT);
+        }
+};
+
+/*
+ * Output depth: fromByte() maps a 0-255 result, fromUnit() a 0-1 result
+ * onto the range of the type. countRow() feeds 8-bit rows into a
+ * histogram and ignores the other depths.
+ */
+template<typename T>
+struct DepthTraits;
+
+template<>
+struct DepthTraits<uchar>
+{
+    static inline uchar fromByte(int value) { return (uchar)value; }
+    static inline uchar fromUnit(double value) { return (uchar)round(value * 255); }
+    static inline void countRow(Histogram* hist, const uchar* row, int cols) { if(hist) hist->addRow(row, cols); }
+};
+
+template<>
+struct DepthTraits<ushort>
+{
+    static inline ushort fromByte(int value) { return (ushort)(value * 257); }
+    static inline ushort fromUnit(double value) { return (ushort)round(value * 65535); }
+    static inline void countRow(Histogram*, const ushort*, int) { }
+};
+
+template<>
+struct DepthTraits<float>
+{
+    static inline float fromByte(int value) { return value / 255.f; }
+    static inline float fromUnit(double value) { return (float)value; }
+    static inline void countRow(Histogram*, const float*, int) { }
+};
+
+// Complement of the red channel (eyebrow pipeline)
+template<class Layout, typename OutT>
+Mat_<OutT> CRTransformT(const Mat& frame)
+{
+    PixelReader<Layout> reader(frame);
+    Mat_<OutT> CR_image(reader.rows(), reader.cols());
+
+    int B = 0, G = 0, R = 0;
+    for(int i = 0; i < reader.rows(); ++i)
+    {
+        reader.setRow(i);
+        OutT* dst = CR_image[i];
+        for(int j = 0; j < reader.cols(); ++j)
+        {
+            reader.read(j, B, G, R);
+            dst[j] = DepthTraits<OutT>::fromByte(255 - R);
+        }
+    }
+    return CR_image;
+}
+
+// Pseudo-hue R / (R + G), normalised to the full output range (mouth pipeline)
+template<class Layout, typename OutT>
+Mat_<OutT> transformPseudoHueT(const Mat& frame, Histogram* hist)
+{
+    PixelReader<Layout> reader(frame);
+    Mat_<double> pseudo_hue(reader.rows(), reader.cols());
+    Mat_<OutT> pseudo_hue_norm(reader.rows(), reader.cols());
+
+    double Hmax = DBL_MIN;
+    double Hmin = DBL_MAX;
+    int B = 0, G = 0, R = 0;
+    for(int i = 0; i < reader.rows(); ++i)
+    {
+        reader.setRow(i);
+        double* dst = pseudo_hue[i];
+        for(int j = 0; j < reader.cols(); ++j)
+        {
+            reader.read(j, B, G, R);
+            dst[j] = (R == 0) ? 0.0 : (double)R / (R + G);
+
+            if(dst[j] >= Hmax + numeric_limits<double>::epsilon())
+                Hmax = dst[j];
+            if(dst[j] <= Hmin + numeric_limits<double>::epsilon())
+                Hmin = dst[j];
+        }
+    }
+    double Hrange = (Hmax - Hmin);
+
+    for(int i = 0; i < reader.rows(); ++i)
+    {
+        const double* src = pseudo_hue[i];
+        OutT* dst = pseudo_hue_norm[i];
+        for(int j = 0; j < reader.cols(); ++j)
+            dst[j] = DepthTraits<OutT>::fromUnit((src[j] - Hmin) / Hrange);
+        DepthTraits<OutT>::countRow(hist, dst, reader.cols());
+    }
+    return pseudo_hue_norm;
+}
+
+// Number of fractional bits used by the fixed-point pseudo-hue plane
+const int PSEUDO_HUE_Q = 15;
+
+/*
+ * Ratio n * F / d for 0 <= n <= d < 2^16 and F <= 2^15 on 16-bit lanes.
+ * d is normalised to d * scale in [2^15, 2^16) (scale a power of two)
+ * and the multiplier is ceil(F * 2^16 / (d * scale)), so the ratio is one
+ * 16-bit multiply by scale and one 16-bit multiply-high, without any
+ * division. The result is within one of n * F / d.
+ */
+struct FixedRatio
+{
+    ushort scale;
+    ushort multiplier;
+};
+
+inline FixedRatio fixedRatio(int d, int F)
+{
+    FixedRatio ratio;
+    ratio.scale = 1;
+    while(d * ratio.scale * 2 <= USHRT_MAX)
+        ratio.scale *= 2;
+
+    uint64 normalised = (uint64)d * ratio.scale;
+    uint64 multiplier = (((uint64)F << 16) + normalised - 1) / normalised;
+    ratio.multiplier = (ushort)min(multiplier, (uint64)USHRT_MAX);
+    return ratio;
+}
+
+inline int fixedScale(int n, FixedRatio ratio)
+{
+    ushort normalised = (ushort)(n * ratio.scale);
+    return (int)(((unsigned)normalised * ratio.multiplier) >> 16);
+}
+
+/*
+ * Fixed-point counterpart of transformPseudoHueT<Layout, uchar>(). The
+ * pseudo-hue H = R / (R + G) lies in [0, 1] and is stored in Q15, off by
+ * at most 2^-15. The division by R + G takes its FixedRatio from a table
+ * of the 510 possible sums and the normalisation uses one FixedRatio for
+ * the whole plane (in Q7 of a gray level, then rounded), so both loops
+ * run on 16-bit values only.
+ *
+ * Error bound against the double path: with r = Hmax - Hmin, the
+ * quantised numerator and range are each off by at most 2^-14, so the
+ * normalised value (before rounding to a gray level) is off by at most
+ * 1020 / (2^15 * r - 2) + 1/64. For r > 0.032 that is below one level,
+ * hence the two outputs never differ by more than 1. Mouth ROIs typically
+ * have r > 0.1, i.e. a deviation below 0.33 of a level.
+ */
+template<class Layout>
+Mat_<uchar> transformPseudoHueFixedT(const Mat& frame, Histogram* hist)
+{
+    PixelReader<Layout> reader(frame);
+    Mat_<ushort> pseudo_hue(reader.rows(), reader.cols());
+    Mat_<uchar> pseudo_hue_norm(reader.rows(), reader.cols());
+
+    // R = G = 0 gives a zero scale, so H = 0 as in the double path
+    FixedRatio sum_ratio[2 * 255 + 1];
+    sum_ratio[0].scale = 0;
+    sum_ratio[0].multiplier = 0;
+    for(int sum = 1; sum <= 2 * 255; ++sum)
+        sum_ratio[sum] = fixedRatio(sum, 1 << PSEUDO_HUE_Q);
+
+    int Hmin = USHRT_MAX, Hmax = 0;
+    int B = 0, G = 0, R = 0;
+    for(int i = 0; i < reader.rows(); ++i)
+    {
+        reader.setRow(i);
+        ushort* dst = pseudo_hue[i];
+        for(int j = 0; j < reader.cols(); ++j)
+        {
+            reader.read(j, B, G, R);
+            int H = fixedScale(R, sum_ratio[R + G]);
+            dst[j] = (ushort)H;
+            Hmin = min(Hmin, H);
+            Hmax = max(Hmax, H);
+        }
+    }
+    int Hrange = (Hmax - Hmin);
+
+    // A flat plane carries no information; the double path would divide by zero
+    if(Hrange == 0)
+    {
+        pseudo_hue_norm = (uchar)0;
+        if(hist)
+            hist->addImage(pseudo_hue_norm);
+        return pseudo_hue_norm;
+    }
+
+    FixedRatio range_ratio = fixedRatio(Hrange, 255 << 7);
+    for(int i = 0; i < reader.rows(); ++i)
+    {
+        const ushort* src = pseudo_hue[i];
+        uchar* dst = pseudo_hue_norm[i];
+        for(int j = 0; j < reader.cols(); ++j)
+            dst[j] = (uchar)((fixedScale(src[j] - Hmin, range_ratio) + 64) >> 7);
+        if(hist)
+            hist->addRow(dst, reader.cols());
+    }
+    return pseudo_hue_norm;
+}
+
+// U plane of the LUX colour space (mouth pipeline)
+template<class Layout, typename OutT>
+Mat_<OutT> transformLUXT(const Mat& frame)
+{
+    PixelReader<Layout> reader(frame);
+    Mat_<OutT> U(reader.rows(), reader.cols());
+
+    int B = 0, G = 0, R = 0, L_int = 0;
+    for(int i = 0; i < reader.rows(); ++i)
+    {
+        reader.setRow(i);
+        OutT* dst = U[i];
+        for(int j = 0; j < reader.cols(); ++j)
+        {
+            reader.read(j, B, G, R);
+            double L = (pow(R+1, 0.3) * pow(G+1, 0.6) * pow(B+1, 0.1)) - 1;
+            L_int = round(L);
+
+            if(R > L_int)
+                dst[j] = DepthTraits<OutT>::fromByte((256 * (L_int+1)) / (R + 1));
+            else
+                dst[j] = DepthTraits<OutT>::fromByte(255);
+        }
+    }
+    return U;
+}
+
+// Modified U plane, 256 * G / R where red dominates (mouth pipeline)
+template<class Layout, typename OutT>
+Mat_<OutT> transformModifiedLUXT(const Mat& frame)
+{
+    PixelReader<Layout> reader(frame);
+    Mat_<OutT> Ucap(reader.rows(), reader.cols());
+
+    int B = 0, G = 0, R = 0;
+    for(int i = 0; i < reader.rows(); ++i)
+    {
+        reader.setRow(i);
+        OutT* dst = Ucap[i];
+        for(int j = 0; j < reader.cols(); ++j)
+        {
+            reader.read(j, B, G, R);
+            if(R > G)
+                dst[j] = DepthTraits<OutT>::fromByte((256 * G) / R);
+            else
+                dst[j] = DepthTraits<OutT>::fromByte(255);
+        }
+    }
+    return Ucap;
+}
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef _MOTION_GATE_CPP
+#define _MOTION_GATE_CPP
+
+#include <iostream>
+#include <cstdlib>
+#include <algorithm>
+#include "motion_gate.h"
+
+using namespace std;
+using namespace cv;
+
+MotionParams::MotionParams()
+    :block_size(16), threshold(8), refresh_interval(150), settle_frames(5)
+{
+}
+
+MotionStats::MotionStats()
+    :frames(0), static_frames(0), refreshes(0), blocks(0), changed_blocks(0)
+{
+}
+
+MotionGate::MotionGate(const MotionParams& _params)
+    :params(_params), frames_since_refresh(0), refresh(false)
+{
+}
+
+/*
+ * Marks the blocks of frame that differ from the reference, or did so
+ * within the last settle_frames frames, and returns whether any are
+ * marked. The first frame, a change of size and every refresh_interval
+ * frames mark all blocks as changed.
+ */
+bool MotionGate::update(const Mat& frame)
+{
+    Mat_<uchar> gray;
+    if(frame.channels() == 3)
+        cvtColor(frame, gray, CV_BGR2GRAY);
+    else if(frame.channels() == 4)
+        cvtColor(frame, gray, CV_BGRA2GRAY);
+    else
+        gray = frame;
+
+    const int block_size = params.block_size;
+    const int block_rows = (gray.rows + block_size - 1) / block_size;
+    const int block_cols = (gray.cols + block_size - 1) / block_size;
+
+    stats.frames++;
+    stats.blocks += (int64)block_rows * block_cols;
+    frame_size = gray.size();
+
+    refresh = reference.empty() || (reference.size() != gray.size()) ||
+        (params.refresh_interval > 0 && frames_since_refresh >= params.refresh_interval);
+    if(refresh)
+    {
+        if(reference.size() != gray.size())
+            settling = Mat_<uchar>(block_rows, block_cols, (uchar)0);
+        reference = gray.clone();
+        changed = Mat_<uchar>(block_rows, block_cols, (uchar)1);
+        frames_since_refresh = 0;
+        stats.refreshes++;
+        stats.changed_blocks += (int64)block_rows * block_cols;
+        return true;
+    }
+    frames_since_refresh++;
+
+    // Block sums of |frame - reference| from an integral image, four lookups per block.
+    // The 32-bit sums may wrap on very large frames; the block differences are taken
+    // modulo 2^32 and stay exact, since a single block sums to far less than that.
+    Mat_<uchar> difference;
+    absdiff(gray, reference, difference);
+    Mat_<int> difference_sum;
+    integral(difference, difference_sum, CV_32S);
+
+    int64 changed_count = 0;
+    for(int by = 0; by < block_rows; ++by)
+    {
+        const int y0 = by * block_size;
+        const int y1 = min(y0 + block_size, gray.rows);
+        const int* top = difference_sum[y0];
+        const int* bottom = difference_sum[y1];
+
+        uchar* changed_row = changed[by];
+        uchar* settling_row = settling[by];
+        for(int bx = 0; bx < block_cols; ++bx)
+        {
+            const int x0 = bx * block_size;
+            const int x1 = min(x0 + block_size, gray.cols);
+            unsigned sad = (unsigned)bottom[x1] - (unsigned)bottom[x0] - (unsigned)top[x1] + (unsigned)top[x0];
+            if((int64)sad > (int64)params.threshold * (y1 - y0) * (x1 - x0))
+            {
+                Rect block(x0, y0, x1 - x0, y1 - y0);
+                Mat reference_block = reference(block);
+                gray(block).copyTo(reference_block);
+                settling_row[bx] = (uchar)min(max(params.settle_frames, 0), 255);
+                changed_row[bx] = 1;
+            }
+            else if(settling_row[bx] > 0)
+            {
+                --settling_row[bx];
+                changed_row[bx] = 1;
+            }
+            else
+                changed_row[bx] = 0;
+
+            if(changed_row[bx])
+                ++changed_count;
+        }
+    }
+
+    stats.changed_blocks += changed_count;
+    if(changed_count == 0)
+        stats.static_frames++;
+    return (changed_count > 0);
+}
+
+// True if no block overlapping region is marked as changed by the last update()
+bool MotionGate::isStatic(const Rect_<int>& region) const
+{
+    if(changed.empty())
+        return false;
+
+    Rect_<int> clipped = region & Rect_<int>(0, 0, frame_size.width, frame_size.height);
+    if(clipped.area() == 0)
+        return true;
+
+    const int block_size = params.block_size;
+    for(int by = clipped.y / block_size; by <= (clipped.y + clipped.height - 1) / block_size; ++by)
+    {
+        const uchar* changed_row = changed[by];
+        for(int bx = clipped.x / block_size; bx <= (clipped.x + clipped.width - 1) / block_size; ++bx)
+        {
+            if(changed_row[bx])
+                return false;
+        }
+    }
+    return true;
+}
+
+// True if the last update() marked every block as changed
+bool MotionGate::isRefresh() const
+{
+    return refresh;
+}
+
+// Bounding box in pixels of the blocks changed in the last update(), empty if none
+Rect_<int> MotionGate::changedRegion() const
+{
+    int min_bx = changed.cols, max_bx = -1, min_by = changed.rows, max_by = -1;
+    for(int by = 0; by < changed.rows; ++by)
+    {
+        const uchar* changed_row = changed[by];
+        for(int bx = 0; bx < changed.cols; ++bx)
+        {
+            if(!changed_row[bx])
+                continue;
+            min_bx = min(min_bx, bx);
+            max_bx = max(max_bx, bx);
+            min_by = min(min_by, by);
+            max_by = max(max_by, by);
+        }
+    }
+    if(max_bx < 0)
+        return Rect_<int>();
+
+    const int block_size = params.block_size;
+    Rect_<int> region(min_bx * block_size, min_by * block_size, (max_bx - min_bx + 1) * block_size,
+            (max_by - min_by + 1) * block_size);
+    return region & Rect_<int>(0, 0, frame_size.width, frame_size.height);
+}
+
+MotionStats MotionGate::getStats() const
+{
+    return stats;
+}
+
+void MotionGate::printStats() const
+{
+    double static_ratio = (stats.frames > 0) ? 100.0 * stats.static_frames / stats.frames : 0.0;
+    double changed_ratio = (stats.blocks > 0) ? 100.0 * stats.changed_blocks / stats.blocks : 0.0;
+    cout << "Motion gate: " << stats.frames << " frames, " << stats.static_frames << " unchanged ("
+        << static_ratio << "%), " << stats.refreshes << " full refreshes, " << changed_ratio
+        << "% of blocks changed\n";
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef _MOTION_GATE_H
+#define _MOTION_GATE_H
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+using namespace std;
+using namespace cv;
+
+struct MotionParams
+{
+    int block_size;                             // side of a block in pixels
+    int threshold;                              // mean absolute difference (gray levels) of a changed block
+    int refresh_interval;                       // frames between forced full updates, 0 for never
+    int settle_frames;                          // frames a block stays changed after its last difference
+
+    MotionParams();
+};
+
+struct MotionStats
+{
+    int64 frames;
+    int64 static_frames;
+    int64 refreshes;
+    int64 blocks;
+    int64 changed_blocks;
+
+    MotionStats();
+};
+
+/*
+ * Block-wise change detection for streaming input from a fixed camera.
+ * Each frame is compared, block by block, against the grayscale content
+ * the current results were computed from. Changed blocks are brought up
+ * to date in that reference, static ones keep their old content, so slow
+ * drift still marks a block once it adds up to the threshold. A block
+ * stays marked for settle_frames further frames after its last change, so
+ * results computed while it was moving (e.g. a face missed in motion
+ * blur) are computed again once it is still.
+ */
+class MotionGate
+{
+    private:
+        MotionParams params;
+        Mat_<uchar> reference;
+        Mat_<uchar> changed;                    // one cell per block, 1 where the block changed
+        Mat_<uchar> settling;                   // frames each block stays marked after its last change
+        Size frame_size;
+        int frames_since_refresh;
+        bool refresh;
+        MotionStats stats;
+
+    public:
+        explicit MotionGate(const MotionParams& _params = MotionParams());
+        bool update(const Mat& frame);
+        bool isStatic(const Rect_<int>& region) const;
+        bool isRefresh() const;
+        Rect_<int> changedRegion() const;
+        MotionStats getStats() const;
+        void printStats() const;
+};
+
+#endif
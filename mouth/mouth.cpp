@@ -8,33 +8,51 @@
 #include <cmath>
 #include <cfloat>
 #include <climits>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
 
 #include "opencv2/highgui/highgui.hpp"
 #include "opencv2/objdetect/objdetect.hpp"
 #include "opencv2/core/core.hpp"
 #include "opencv2/imgproc/imgproc.hpp"
 
+#include "histogram_threshold.h"
+#include "cascade_profile.h"
+#include "face_detector.h"
+#include "image_ingest.h"
+#include "pixel_kernels.h"
+#include "perf_profile.h"
+
 using namespace std;
 using namespace cv;
 
-Mat_<Vec3b> extractFaceROI(Mat_<Vec3b> image, string face_cascade_path);
+// Functions to parse command-line arguments
+static string getCommandOption(const vector<string>&, const string&);
+static void setCommandOptions(vector<string>&, int, char**);
+static bool doesCmdOptionExist(const vector<string>& , const string&);
+
+Mat_<Vec3b> extractFaceROI(Mat_<Vec3b> image, FaceDetector& face_detector, const CascadeParams& params);
+Mat_<Vec3b> extractFaceROIReduced(const string& image_path, FaceDetector& face_detector,
+        const CascadeParams& params, int reduction);
 Mat_<Vec3b> extractMouthROI(Mat_<Vec3b> face_image);
 
 Mat_<Vec3b> equalizeImage(Mat_<Vec3b> image_BGR);
-Mat_<uchar> transformPseudoHue(Mat_<Vec3b> image);
-pair<double, double> Stats(Mat_<double> pseudo_hue_plane);
+Mat_<uchar> transformPseudoHue(Mat_<Vec3b> image, Histogram* hist);
+Mat_<uchar> transformPseudoHueFixed(Mat_<Vec3b> image, Histogram* hist);
 Mat_<uchar> transformCIELAB(Mat_<Vec3b> image_BGR);
 Mat_<uchar> transformLUX(Mat_<Vec3b> image_BGR);
 Mat_<uchar> transformModifiedLUX(Mat_<Vec3b> image_BGR);
 
-pair<double, double> returnImageStats(const Mat_<uchar>& image);
-Mat_<uchar> binaryThresholding(const Mat_<uchar>& image, const pair<double, double>& stats);
+void validateFixedPoint(Mat_<Vec3b> mouth);
 int returnLargestContourIndex(vector<vector<Point> > contours);
 int findClosest(vector<int> x_contour, int x);
+bool writeLandmarks(const string& landmarks_path, const string& pipeline, const vector<Point>& landmarks,
+        double pipeline_time);
 
 int main(int argc, char** argv)
 {
-    if(argc != 3)
+    if(argc < 3)
     {
         cout << "Paramters missing\n";
         return -1;
@@ -43,18 +61,114 @@ int main(int argc, char** argv)
     const string input_image_path = argv[1];
     const string face_cascade_path = argv[2];
 
-    Mat_<Vec3b> image_BGR = imread(input_image_path);
-    Mat_<Vec3b> face = extractFaceROI(image_BGR, face_cascade_path);
-    Mat_<Vec3b> mouth = extractMouthROI(face);
+    // Extract command-line options
+    vector<string> args;
+    setCommandOptions(args, argc, argv);
+
+    // -perf counts cycles, instructions and cache/branch misses per stage
+    if(doesCmdOptionExist(args, "-perf"))
+        perfProfiler().enable();
+
+    // Load detectMultiScale() parameters if a tuning profile is provided
+    CascadeProfile cascade_profile;
+    if(doesCmdOptionExist(args, "-profile") && !cascade_profile.load(getCommandOption(args, "-profile")))
+    {
+        cout << "Unable to read the tuning profile " << getCommandOption(args, "-profile") << "\n";
+        return -1;
+    }
+    if(doesCmdOptionExist(args, "-detector"))
+        cascade_profile.setFaceDetector(getCommandOption(args, "-detector"));
+
+    // -roi takes the input image as the mouth ROI itself (FACE_CASCADE is then ignored)
+    Mat_<Vec3b> mouth;
+    if(doesCmdOptionExist(args, "-roi"))
+        mouth = imread(input_image_path);
+    else
+    {
+        Ptr<FaceDetector> face_detector = createFaceDetector(cascade_profile.getFaceDetector());
+        if(face_detector.empty() || !face_detector->load(face_cascade_path))
+        {
+            cout << "Unable to load " << face_cascade_path << " as a " << cascade_profile.getFaceDetector()
+                << " face detector\n";
+            return -1;
+        }
+
+        // -reduce N finds the face on a 1/N grayscale decode, the full resolution is kept for the face only
+        Mat_<Vec3b> face;
+        if(doesCmdOptionExist(args, "-reduce"))
+        {
+            int reduction = atoi(getCommandOption(args, "-reduce").c_str());
+            if(!isReductionSupported(reduction))
+            {
+                cout << "-reduce takes 2, 4 or 8\n";
+                return -1;
+            }
+            face = extractFaceROIReduced(input_image_path, *face_detector, cascade_profile.get("face"), reduction);
+        }
+        else
+        {
+            Mat_<Vec3b> image_BGR = imread(input_image_path);
+            face = extractFaceROI(image_BGR, *face_detector, cascade_profile.get("face"));
+        }
+        mouth = extractMouthROI(face);
+    }
+    if(mouth.empty())
+    {
+        cout << "No mouth region found\n";
+        return -1;
+    }
+    int64 pipeline_start = getTickCount();
+
+    // -equalize normalizes the lighting of the mouth ROI before the colour transforms
+    if(doesCmdOptionExist(args, "-equalize"))
+        mouth = equalizeImage(mouth);
     
-    Mat_<uchar> pseudo_hue_plane = transformPseudoHue(mouth);
-    Mat_<uchar> pseudo_hue_bin = binaryThresholding(pseudo_hue_plane, 
-            returnImageStats(pseudo_hue_plane));
+    // Threshold at mean + 0.9 * std_dev unless another strategy is requested
+    ThresholdStrategy strategy = THRESHOLD_MEAN_STD;
+    double strategy_param = 0.9;
+    if(doesCmdOptionExist(args, "-otsu"))
+        strategy = THRESHOLD_OTSU;
+    else if(doesCmdOptionExist(args, "-percentile"))
+    {
+        strategy = THRESHOLD_PERCENTILE;
+        strategy_param = atof(getCommandOption(args, "-percentile").c_str());
+    }
+
+    // The histogram is filled by the transform itself, so thresholding costs O(256)
+    // -fixed selects the all-integer pseudo-hue and threshold path
+    Histogram pseudo_hue_hist;
+    Mat_<uchar> pseudo_hue_plane;
+    int threshold_level = 0;
+    if(doesCmdOptionExist(args, "-fixed"))
+    {
+        pseudo_hue_plane = transformPseudoHueFixed(mouth, &pseudo_hue_hist);
+        threshold_level = (strategy == THRESHOLD_MEAN_STD) ? thresholdMeanStdFixed(pseudo_hue_hist) :
+            computeThreshold(pseudo_hue_hist, strategy, strategy_param);
+    }
+    else
+    {
+        pseudo_hue_plane = transformPseudoHue(mouth, &pseudo_hue_hist);
+        threshold_level = computeThreshold(pseudo_hue_hist, strategy, strategy_param);
+    }
+    Mat_<uchar> pseudo_hue_bin;
+    {
+        PerfScope scope("threshold", pseudo_hue_plane.total());
+        pseudo_hue_bin = applyThreshold(pseudo_hue_plane, threshold_level);
+    }
+
+    // -validate compares the fixed-point path against the double path
+    if(doesCmdOptionExist(args, "-validate"))
+        validateFixedPoint(mouth);
     
     // A clone image is required because findContours() modifies the input image
-    Mat binary_clone = pseudo_hue_bin.clone();
     vector<vector<Point> > contours;
-    findContours(binary_clone, contours, CV_RETR_LIST, CV_CHAIN_APPROX_NONE);
+    int largest_contour_idx = -1;
+    {
+        PerfScope scope("contours", pseudo_hue_bin.total());
+        Mat binary_clone = pseudo_hue_bin.clone();
+        findContours(binary_clone, contours, CV_RETR_LIST, CV_CHAIN_APPROX_NONE);
+        largest_contour_idx = returnLargestContourIndex(contours);
+    }
     
     // Initialize blank image (for drawing contours)
     Mat_<Vec3b> image_contour(pseudo_hue_bin.size());
@@ -69,7 +183,11 @@ int main(int argc, char** argv)
     }
 
     // Draw largest contour on the blank image
-    int largest_contour_idx = returnLargestContourIndex(contours);
+    if(largest_contour_idx < 0)
+    {
+        cout << "No lip contour found\n";
+        return -1;
+    }
     vector<Point> largest_contour = contours[largest_contour_idx];
     vector<int> x_contour(largest_contour.size());
     vector<int> y_contour(largest_contour.size());
@@ -119,6 +237,21 @@ int main(int argc, char** argv)
         }
     }
 
+    double pipeline_time = (getTickCount() - pipeline_start) * 1000.0 / getTickFrequency();
+    if(perfProfiler().isEnabled())
+        perfProfiler().printReport();
+
+    // -landmarks writes the lip corners and mid-points instead of showing them
+    if(doesCmdOptionExist(args, "-landmarks"))
+    {
+        vector<Point> landmarks;
+        landmarks.push_back(Point(min_x, min_y));
+        landmarks.push_back(Point(max_x, max_y));
+        for(int i = 0; i < mid_y_values.size(); ++i)
+            landmarks.push_back(Point(closest_mid_x, mid_y_values[i]));
+        return writeLandmarks(getCommandOption(args, "-landmarks"), "mouth", landmarks, pipeline_time) ? 0 : -1;
+    }
+
     // Mark end-points
     circle(image_contour, Point(min_x, min_y), 3.0, Scalar(0, 0, 255), -1, 8);
     circle(image_contour, Point(max_x, max_y), 3.0, Scalar(0, 0, 255), -1, 8);
@@ -152,13 +285,35 @@ int main(int argc, char** argv)
     return 0;
 }
 
-Mat_<Vec3b> extractFaceROI(Mat_<Vec3b> image, string face_cascade_path)
+string getCommandOption(const vector<string>& args, const string& opt)
+{
+    string answer;
+    vector<string>::const_iterator it = find(args.begin(), args.end(), opt);
+    if(it != args.end() && (++it != args.end()))
+        answer = *it;
+    return answer;
+}
+
+void setCommandOptions(vector<string>& args, int argc, char** argv)
+{
+    for(int i = 1; i < argc; ++i)
+    {
+        args.push_back(argv[i]);
+    }
+    return;
+}
+
+bool doesCmdOptionExist(const vector<string>& args, const string& opt)
+{
+    vector<string>::const_iterator it = find(args.begin(), args.end(), opt);
+    return (it != args.end());
+}
+
+Mat_<Vec3b> extractFaceROI(Mat_<Vec3b> image, FaceDetector& face_detector, const CascadeParams& params)
 {
-    CascadeClassifier face_cascade;
     vector<Rect_<int> > faces;
     
-    face_cascade.load(face_cascade_path);
-    face_cascade.detectMultiScale(image, faces, 1.15, 3, 0|CASCADE_SCALE_IMAGE, Size(30, 30));
+    face_detector.detect(image, faces, params);
 
     Mat_<Vec3b> face_ROI;
     for(int i = 0; i < faces.size(); ++i)
@@ -182,6 +337,24 @@ Mat_<Vec3b> extractFaceROI(Mat_<Vec3b> image, string face_cascade_path)
     return face_ROI;
 }
 
+Mat_<Vec3b> extractFaceROIReduced(const string& image_path, FaceDetector& face_detector,
+        const CascadeParams& params, int reduction)
+{
+    vector<Rect_<int> > faces;
+    ImageIngest ingest(image_path, reduction);
+
+    face_detector.detect(ingest.detectionImage(), faces, ingest.detectionParams(params));
+
+    // Like extractFaceROI(), the last face found is used, so only that face is decoded
+    Mat_<Vec3b> face_ROI;
+    if(faces.empty())
+        return face_ROI;
+    vector<FaceCrop> face_crops = ingest.decodeFaceCrops(vector<Rect_<int> >(1, faces.back()));
+    if(!face_crops.empty())
+        face_ROI = face_crops[0].image;
+    return face_ROI;
+}
+
 Mat_<Vec3b> extractMouthROI(Mat_<Vec3b> face_image)
 {
     int face_rows = face_image.rows;
@@ -194,79 +367,93 @@ Mat_<Vec3b> extractMouthROI(Mat_<Vec3b> face_image)
 }
 
 
+// Luma of a BGR pixel, with the fixed-point coefficients of CV_BGR2YCrCb
+static inline int lumaBGR(const Vec3b& pixel)
+{
+    return (pixel[0] * 1868 + pixel[1] * 9617 + pixel[2] * 4899 + (1 << 13)) >> 14;
+}
+
 /*
- * Equalize a BGR image by converting it to the YCrCb space and
- * performing histogram equalization on the Y-plane before
- * merging back
+ * Equalize a BGR image on its luma, as converting it to the YCrCb space,
+ * equalizing the Y-plane and converting back would. Since YCrCb -> BGR is
+ * linear in Y with Cr and Cb fixed, changing Y by d changes each of B, G
+ * and R by d, so the work is done in two passes over the interleaved
+ * pixels (histogram, then remap) without any intermediate planes. Meant
+ * to be applied to the face or mouth ROI only.
  */
 Mat_<Vec3b> equalizeImage(Mat_<Vec3b> image_BGR)
 {
-    vector<Mat> channels;
-    Mat_<Vec3b> image_eq;
+    PerfScope scope("equalize", image_BGR.total());
+    Mat_<Vec3b> image_eq(image_BGR.size());
+    if(image_BGR.empty())
+        return image_eq;
 
-    cvtColor(image_BGR, image_eq, CV_BGR2YCrCb);
-    split(image_eq, channels);
-    equalizeHist(channels[0], channels[0]);
-    merge(channels, image_eq);
-    cvtColor(image_eq, image_eq, CV_YCrCb2BGR);
-
-    return image_eq;
-}
+    Histogram luma_hist;
+    vector<uchar> luma_row(image_BGR.cols);
+    for(int i = 0; i < image_BGR.rows; ++i)
+    {
+        const Vec3b* src = image_BGR[i];
+        for(int j = 0; j < image_BGR.cols; ++j)
+            luma_row[j] = (uchar)lumaBGR(src[j]);
+        luma_hist.addRow(&luma_row[0], image_BGR.cols);
+    }
 
-// Extract the pseudo-hue plane
-Mat_<uchar> transformPseudoHue(Mat_<Vec3b> image)
-{
-    Mat_<double> pseudo_hue(image.size());
-    Mat_<uchar> pseudo_hue_norm(image.size());
+    // Same mapping as equalizeHist()
+    int64 counts[HISTOGRAM_LEVELS];
+    luma_hist.levels(counts);
+    int64 total_pixels = (int64)image_BGR.rows * image_BGR.cols;
 
-    int B = 0, G = 0, R = 0;
-    for(int i = 0; i < image.rows; ++i)
+    int lut[HISTOGRAM_LEVELS];
+    int k = 0;
+    while(counts[k] == 0)
+        ++k;
+    if(counts[k] == total_pixels)
+    {
+        for(int l = 0; l < HISTOGRAM_LEVELS; ++l)
+            lut[l] = k;
+    }
+    else
     {
-        for(int j = 0; j < image.cols; ++j)
+        float scale = (HISTOGRAM_LEVELS - 1.f) / (total_pixels - counts[k]);
+        int64 sum = 0;
+        for(int l = 0; l <= k; ++l)
+            lut[l] = 0;
+        for(++k; k < HISTOGRAM_LEVELS; ++k)
         {
-            B = image(i, j)[0];
-            G = image(i, j)[1];
-            R = image(i, j)[2];
-
-            if(R == 0)
-                pseudo_hue.at<double>(i, j) = 0.0;
-            else
-                pseudo_hue.at<double>(i, j) = (double)R / (R + G);
+            sum += counts[k];
+            lut[k] = saturate_cast<uchar>(sum * scale);
         }
     }
-    pair<double, double> statistics = Stats(pseudo_hue);
-    double Hmin = statistics.first;
-    double Hmax = statistics.second;
-    double Hrange = (Hmax - Hmin);
-    
-    for(int i = 0; i < image.rows; ++i)
+
+    for(int i = 0; i < image_BGR.rows; ++i)
     {
-        for(int j = 0; j < image.cols; ++j)
+        const Vec3b* src = image_BGR[i];
+        Vec3b* dst = image_eq[i];
+        for(int j = 0; j < image_BGR.cols; ++j)
         {
-            double  temp = (pseudo_hue.at<double>(i, j) - Hmin) / Hrange;
-            pseudo_hue_norm.at<uchar>(i, j) = round(temp * 255);
+            int Y = lumaBGR(src[j]);
+            int delta = lut[Y] - Y;
+            dst[j][0] = saturate_cast<uchar>(src[j][0] + delta);
+            dst[j][1] = saturate_cast<uchar>(src[j][1] + delta);
+            dst[j][2] = saturate_cast<uchar>(src[j][2] + delta);
         }
     }
 
-    return pseudo_hue_norm;
+    return image_eq;
 }
 
-pair<double, double> Stats(Mat_<double> pseudo_hue_plane)
+// Extract the pseudo-hue plane (and its histogram, if requested)
+Mat_<uchar> transformPseudoHue(Mat_<Vec3b> image, Histogram* hist)
 {
-    double Hmax = DBL_MIN;
-    double Hmin = DBL_MAX;
+    PerfScope scope("pseudo-hue", image.total());
+    return transformPseudoHueT<LayoutBGR, uchar>(image, hist);
+}
 
-    for(int i = 0; i < pseudo_hue_plane.rows; ++i)
-    {
-        for(int j = 0; j < pseudo_hue_plane.cols; ++j)
-        {
-            if(pseudo_hue_plane.at<double>(i, j) >= Hmax + numeric_limits<double>::epsilon())
-                Hmax = pseudo_hue_plane.at<double>(i, j);
-            if(pseudo_hue_plane.at<double>(i, j) <= Hmin + numeric_limits<double>::epsilon())
-                Hmin = pseudo_hue_plane.at<double>(i, j);
-        }
-    }
-    return make_pair(Hmin, Hmax);
+// Fixed-point counterpart of transformPseudoHue(), see transformPseudoHueFixedT()
+Mat_<uchar> transformPseudoHueFixed(Mat_<Vec3b> image, Histogram* hist)
+{
+    PerfScope scope("pseudo-hue fixed", image.total());
+    return transformPseudoHueFixedT<LayoutBGR>(image, hist);
 }
 
 // CIELAB transformation and using the A-channel
@@ -283,102 +470,54 @@ Mat_<uchar> transformCIELAB(Mat_<Vec3b> image_BGR)
 
 Mat_<uchar> transformLUX(Mat_<Vec3b> image_BGR)
 {
-    Mat_<uchar> U(image_BGR.size());
-    
-    int B = 0, G = 0, R = 0, L_int = 0, u_int = 0;
-    double L = 0.0, u = 0.0;
-    for(int i = 0; i < image_BGR.rows; ++i)
-    {
-        for(int j = 0; j < image_BGR.cols; ++j)
-        {
-            B = image_BGR(i, j)[0];
-            G = image_BGR(i, j)[1];
-            R = image_BGR(i, j)[2];
-
-            L = (pow(R+1, 0.3) * pow(G+1, 0.6) * pow(B+1, 0.1)) - 1;
-            L_int = round(L);
-            
-            if(R > L_int)
-            {
-                u = (256 * (L_int+1)) / (R + 1);
-                u_int = round(u);
-                U.at<uchar>(i, j) = u_int;
-            }
-            else
-                U.at<uchar>(i, j) = 255;
-        }
-    }
-    return U;
+    return transformLUXT<LayoutBGR, uchar>(image_BGR);
 }
 
 Mat_<uchar> transformModifiedLUX(Mat_<Vec3b> image_BGR)
 {
-    Mat_<uchar> Ucap(image_BGR.size());
-    
-    int B = 0, G = 0, R = 0, u_cap_int = 0;
-    double u_cap = 0.0;
-    for(int i = 0; i < image_BGR.rows; ++i)
-    {
-        for(int j = 0; j < image_BGR.cols; ++j)
-        {
-            B = image_BGR(i, j)[0];
-            G = image_BGR(i, j)[1];
-            R = image_BGR(i, j)[2];
-
-            if(R > G)
-            {
-                u_cap = (256*G) / R;
-                u_cap_int = round(u_cap);
-                Ucap.at<uchar>(i, j) = u_cap_int;
-            }
-            else
-                Ucap.at<uchar>(i, j) = 255;
-        }
-    }
-    return Ucap;
+    return transformModifiedLUXT<LayoutBGR, uchar>(image_BGR);
 }
 
-pair<double, double> returnImageStats(const Mat_<uchar>& image)
+/*
+ * Run the double and the fixed-point pipelines on the same mouth ROI and
+ * report how far apart the pseudo-hue planes and binary masks are.
+ * regression/FixedPointCheck does the same over a directory of ROIs.
+ * The kernels are called directly rather than through the PerfScope
+ * wrappers, so -perf -validate reports only the stages of the pipeline.
+ */
+void validateFixedPoint(Mat_<Vec3b> mouth)
 {
-    double mean = 0.0, std_dev = 0.0;
-    int total_pixels = (image.rows * image.cols);
-    
-    int intensity_sum = 0;
-    for(int i = 0; i < image.rows; ++i)
-    {
-        for(int j = 0; j < image.cols; ++j)
-            intensity_sum += image.at<uchar>(i, j);
-    }
-    mean = (double)intensity_sum/total_pixels;
+    Histogram hist_double, hist_fixed;
 
-    int sum_sq = 0;
-    for(int i = 0; i < image.rows; ++i)
-    {
-        for(int j = 0; j < image.cols; ++j)
-            sum_sq += ( (image.at<uchar>(i, j) - mean) * (image.at<uchar>(i, j) - mean) );
-    }
-    std_dev = sqrt((double)sum_sq/total_pixels);
+    int64 start = getTickCount();
+    Mat_<uchar> hue_double = transformPseudoHueT<LayoutBGR, uchar>(mouth, &hist_double);
+    Mat_<uchar> bin_double = applyThreshold(hue_double, thresholdMeanStd(hist_double, 0.9));
+    double time_double = (getTickCount() - start) * 1000.0 / getTickFrequency();
 
-    return make_pair(mean, std_dev);
-}
+    start = getTickCount();
+    Mat_<uchar> hue_fixed = transformPseudoHueFixedT<LayoutBGR>(mouth, &hist_fixed);
+    Mat_<uchar> bin_fixed = applyThreshold(hue_fixed, thresholdMeanStdFixed(hist_fixed));
+    double time_fixed = (getTickCount() - start) * 1000.0 / getTickFrequency();
 
-Mat_<uchar> binaryThresholding(const Mat_<uchar>& image, const pair<double, double>& stats)
-{
-    Mat_<uchar> image_binary(image.size());
-    
-    double Z = 0.9;
-    double threshold = stats.first + (Z * stats.second); 
-    for(int i = 0; i < image.rows; ++i)
+    int max_hue_diff = 0, hue_mismatches = 0, bin_mismatches = 0;
+    for(int i = 0; i < mouth.rows; ++i)
     {
-        for(int j = 0; j < image.cols; ++j)
+        for(int j = 0; j < mouth.cols; ++j)
         {
-            if(image.at<uchar>(i, j) >= threshold + numeric_limits<double>::epsilon())
-                image_binary.at<uchar>(i, j) = 255;
-            else
-                image_binary.at<uchar>(i, j) = 0;
+            int diff = abs((int)hue_double(i, j) - (int)hue_fixed(i, j));
+            max_hue_diff = max(max_hue_diff, diff);
+            if(diff != 0)
+                ++hue_mismatches;
+            if(bin_double(i, j) != bin_fixed(i, j))
+                ++bin_mismatches;
         }
     }
-    return image_binary;
+
+    cout << "Fixed-point validation on " << mouth.rows << " X " << mouth.cols << " mouth ROI\n"
+        << "\tpseudo-hue: max deviation " << max_hue_diff << ", " << hue_mismatches
+        << " pixels differ\n"
+        << "\tbinary: " << bin_mismatches << " pixels differ\n"
+        << "\ttime: double " << time_double << " ms, fixed " << time_fixed << " ms\n";
 }
 
 int returnLargestContourIndex(vector<vector<Point> > contours)
@@ -414,3 +553,24 @@ int findClosest(vector<int> x_contour, int x)
     }
     return min_diff_idx;
 }
+
+/*
+ * Store the landmarks and the time the pixel pipeline took, in the
+ * format read by the regression harness (see regression/)
+ */
+bool writeLandmarks(const string& landmarks_path, const string& pipeline, const vector<Point>& landmarks,
+        double pipeline_time)
+{
+    FileStorage fs(landmarks_path, FileStorage::WRITE);
+    if(!fs.isOpened())
+    {
+        cout << "Unable to write " << landmarks_path << "\n";
+        return false;
+    }
+
+    fs << "pipeline" << pipeline << "time_ms" << pipeline_time << "landmarks" << "[";
+    for(unsigned int i = 0; i < landmarks.size(); ++i)
+        fs << landmarks[i].x << landmarks[i].y;
+    fs << "]";
+    return true;
+}
@@ -0,0 +1,307 @@
+#ifndef _PERF_PROFILE_CPP
+#define _PERF_PROFILE_CPP
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include "perf_profile.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+using namespace std;
+using namespace cv;
+
+static const char* PERF_EVENT_NAMES[PERF_EVENTS] = {"cycles", "instructions", "cache-misses", "branch-misses"};
+
+#if defined(__linux__)
+static const unsigned long long PERF_EVENT_CONFIGS[PERF_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+// User-space counter of the calling thread on any CPU, the leader is created disabled
+static int openCounter(unsigned long long config, int group_fd)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (group_fd < 0) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+// Counters of each thread, created on first use and closed when the thread exits
+static pthread_key_t counters_key;
+static pthread_once_t counters_key_once = PTHREAD_ONCE_INIT;
+
+static void deleteCounters(void* counters)
+{
+    delete static_cast<PerfCounters*>(counters);
+}
+
+static void createCountersKey()
+{
+    pthread_key_create(&counters_key, deleteCounters);
+}
+#endif
+
+PerfCounters::PerfCounters()
+    :group_size(0), open_error(0)
+{
+    int leader = -1;
+    for(int e = 0; e < PERF_EVENTS; ++e)
+    {
+        fds[e] = -1;
+        group_index[e] = -1;
+#if defined(__linux__)
+        fds[e] = openCounter(PERF_EVENT_CONFIGS[e], leader);
+        if(fds[e] < 0)
+        {
+            if(open_error == 0)
+                open_error = errno;
+            continue;
+        }
+        if(leader < 0)
+            leader = fds[e];
+        group_index[e] = group_size++;
+#else
+        open_error = ENOSYS;
+#endif
+    }
+
+#if defined(__linux__)
+    if(leader >= 0)
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+    for(int e = 0; e < PERF_EVENTS; ++e)
+    {
+        if(fds[e] >= 0)
+            close(fds[e]);
+    }
+#endif
+}
+
+bool PerfCounters::available(PerfEvent event) const
+{
+    return (fds[event] >= 0);
+}
+
+bool PerfCounters::anyAvailable() const
+{
+    return (group_size > 0);
+}
+
+// errno of the first counter that could not be opened, 0 if all opened
+int PerfCounters::error() const
+{
+    return open_error;
+}
+
+// Current value of each counter, -1 for unavailable counters
+void PerfCounters::read(int64 counts[PERF_EVENTS]) const
+{
+    for(int e = 0; e < PERF_EVENTS; ++e)
+        counts[e] = -1;
+
+#if defined(__linux__)
+    if(group_size == 0)
+        return;
+
+    // { nr, value[nr] } in the order the counters joined the group
+    unsigned long long values[PERF_EVENTS + 1];
+    int leader = -1;
+    for(int e = 0; e < PERF_EVENTS && leader < 0; ++e)
+        leader = fds[e];
+    ssize_t expected = (ssize_t)((group_size + 1) * sizeof(unsigned long long));
+    if(::read(leader, values, sizeof(values)) < expected)
+        return;
+
+    for(int e = 0; e < PERF_EVENTS; ++e)
+    {
+        if(group_index[e] >= 0)
+            counts[e] = (int64)values[1 + group_index[e]];
+    }
+#endif
+}
+
+StageProfile::StageProfile(const string& _name)
+    :name(_name), calls(0), time_ms(0.0), pixels(0)
+{
+    for(int e = 0; e < PERF_EVENTS; ++e)
+    {
+        counts[e] = 0;
+        counted_calls[e] = 0;
+    }
+}
+
+PerfProfiler::PerfProfiler()
+    :enabled(false)
+{
+}
+
+// Probes the counters once and says which ones are unavailable
+void PerfProfiler::enable()
+{
+    enabled = true;
+
+    // Run parallel_for_ bodies on the calling thread, whose counters the stages read
+    setNumThreads(0);
+
+    PerfCounters& probe = threadCounters();
+    if(probe.error() == 0)
+        return;
+
+    cerr << "perf: perf_event_open failed (" << strerror(probe.error()) << ")";
+    if(probe.error() == EACCES || probe.error() == EPERM)
+        cerr << ", see /proc/sys/kernel/perf_event_paranoid";
+    cerr << "\n";
+
+    if(!probe.anyAvailable())
+    {
+        cerr << "perf: hardware counters unavailable, reporting wall-clock time only\n";
+        return;
+    }
+    for(int e = 0; e < PERF_EVENTS; ++e)
+    {
+        if(!probe.available((PerfEvent)e))
+            cerr << "perf: " << PERF_EVENT_NAMES[e] << " counter unavailable\n";
+    }
+}
+
+bool PerfProfiler::isEnabled() const
+{
+    return enabled;
+}
+
+// Counters of the calling thread, opened on the first call from that thread
+PerfCounters& PerfProfiler::threadCounters()
+{
+#if defined(__linux__)
+    pthread_once(&counters_key_once, createCountersKey);
+    PerfCounters* counters = static_cast<PerfCounters*>(pthread_getspecific(counters_key));
+    if(!counters)
+    {
+        counters = new PerfCounters();
+        pthread_setspecific(counters_key, counters);
+    }
+    return *counters;
+#else
+    static PerfCounters counters;
+    return counters;
+#endif
+}
+
+// Stages may be recorded from parallel_for_ workers
+void PerfProfiler::record(const char* stage, double time_ms, int64 pixels, const int64 counts[PERF_EVENTS])
+{
+    AutoLock lock(stages_mutex);
+
+    size_t s = 0;
+    while(s < stages.size() && stages[s].name != stage)
+        ++s;
+    if(s == stages.size())
+        stages.push_back(StageProfile(stage));
+
+    StageProfile& profile = stages[s];
+    profile.calls++;
+    profile.time_ms += time_ms;
+    profile.pixels += pixels;
+    for(int e = 0; e < PERF_EVENTS; ++e)
+    {
+        if(counts[e] < 0)
+            continue;
+        profile.counts[e] += counts[e];
+        profile.counted_calls[e]++;
+    }
+}
+
+vector<StageProfile> PerfProfiler::getStages()
+{
+    AutoLock lock(stages_mutex);
+    return stages;
+}
+
+/*
+ * IPC and bytes/pixel per stage. Bytes/pixel estimates the memory traffic
+ * as one cache line per (last-level) cache miss; a low IPC together with a
+ * high bytes/pixel points at a memory-bound stage.
+ */
+void PerfProfiler::printReport()
+{
+    vector<StageProfile> snapshot = getStages();
+
+    printf("Counters cover the calling thread, OpenCV threads were disabled while profiling\n");
+    printf("%-20s %7s %10s %10s %6s %12s %12s %8s\n", "stage", "calls", "time (ms)", "Mcycles",
+            "IPC", "cache-miss", "branch-miss", "B/px");
+    for(size_t s = 0; s < snapshot.size(); ++s)
+    {
+        const StageProfile& profile = snapshot[s];
+        bool has_cycles = (profile.counted_calls[PERF_CYCLES] > 0);
+        bool has_ipc = has_cycles && (profile.counted_calls[PERF_INSTRUCTIONS] > 0) && (profile.counts[PERF_CYCLES] > 0);
+        bool has_cache = (profile.counted_calls[PERF_CACHE_MISSES] > 0);
+        bool has_branch = (profile.counted_calls[PERF_BRANCH_MISSES] > 0);
+
+        char cycles[32], ipc[32], cache[32], branch[32], bytes[32];
+        snprintf(cycles, sizeof(cycles), has_cycles ? "%.2f" : "n/a", profile.counts[PERF_CYCLES] / 1e6);
+        snprintf(ipc, sizeof(ipc), has_ipc ? "%.2f" : "n/a",
+                has_ipc ? (double)profile.counts[PERF_INSTRUCTIONS] / profile.counts[PERF_CYCLES] : 0.0);
+        snprintf(cache, sizeof(cache), has_cache ? "%lld" : "n/a", (long long)profile.counts[PERF_CACHE_MISSES]);
+        snprintf(branch, sizeof(branch), has_branch ? "%lld" : "n/a", (long long)profile.counts[PERF_BRANCH_MISSES]);
+        snprintf(bytes, sizeof(bytes), (has_cache && profile.pixels > 0) ? "%.3f" : "n/a",
+                (profile.pixels > 0) ? (double)profile.counts[PERF_CACHE_MISSES] * PERF_CACHE_LINE_BYTES / profile.pixels : 0.0);
+
+        printf("%-20s %7lld %10.2f %10s %6s %12s %12s %8s\n", profile.name.c_str(), (long long)profile.calls,
+                profile.time_ms, cycles, ipc, cache, branch, bytes);
+    }
+}
+
+PerfProfiler& perfProfiler()
+{
+    static PerfProfiler profiler;
+    return profiler;
+}
+
+PerfScope::PerfScope(const char* _stage, int64 _pixels)
+    :stage(_stage), pixels(_pixels), counters(NULL), start_ticks(0)
+{
+    if(!perfProfiler().isEnabled())
+        return;
+
+    counters = &perfProfiler().threadCounters();
+    start_ticks = getTickCount();
+    counters->read(start_counts);
+}
+
+PerfScope::~PerfScope()
+{
+    if(!counters)
+        return;
+
+    int64 counts[PERF_EVENTS];
+    counters->read(counts);
+    double time_ms = (getTickCount() - start_ticks) / getTickFrequency() * 1000;
+    for(int e = 0; e < PERF_EVENTS; ++e)
+        counts[e] = (counts[e] < 0 || start_counts[e] < 0) ? -1 : counts[e] - start_counts[e];
+
+    perfProfiler().record(stage, time_ms, pixels, counts);
+}
+
+#endif
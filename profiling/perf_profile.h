@@ -0,0 +1,109 @@
+#ifndef _PERF_PROFILE_H
+#define _PERF_PROFILE_H
+
+#include <string>
+#include <vector>
+#include "opencv2/core/core.hpp"
+
+using namespace std;
+using namespace cv;
+
+// Hardware events counted per stage
+enum PerfEvent
+{
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_EVENTS
+};
+
+// Bytes moved per cache miss, used for the bytes/pixel estimate
+#define PERF_CACHE_LINE_BYTES 64
+
+/*
+ * Hardware counters of the calling thread, opened once with
+ * perf_event_open() as one group that counts from construction on and is
+ * read with a single read() (PERF_FORMAT_GROUP). Counters the kernel
+ * refuses (no PMU in a VM, perf_event_paranoid, other platforms) stay
+ * closed and report -1.
+ */
+class PerfCounters
+{
+    private:
+        int fds[PERF_EVENTS];
+        int group_index[PERF_EVENTS];           // position in the group read, -1 if closed
+        int group_size;
+        int open_error;
+
+        PerfCounters(const PerfCounters&);
+        PerfCounters& operator=(const PerfCounters&);
+
+    public:
+        PerfCounters();
+        ~PerfCounters();
+        bool available(PerfEvent event) const;
+        bool anyAvailable() const;
+        int error() const;
+        void read(int64 counts[PERF_EVENTS]) const;
+};
+
+struct StageProfile
+{
+    string name;
+    int64 calls;
+    double time_ms;
+    int64 pixels;
+    int64 counts[PERF_EVENTS];
+    int64 counted_calls[PERF_EVENTS];
+
+    explicit StageProfile(const string& _name);
+};
+
+/*
+ * Per-stage totals of wall-clock time and counter values. Disabled by
+ * default, in which case PerfScope costs one branch. Counters only see
+ * the thread they belong to, so enable() turns off OpenCV's thread pool:
+ * the time and the counters of a stage then describe the same work.
+ */
+class PerfProfiler
+{
+    private:
+        bool enabled;
+        vector<StageProfile> stages;                // in order of first use
+        Mutex stages_mutex;
+
+        PerfProfiler(const PerfProfiler&);
+        PerfProfiler& operator=(const PerfProfiler&);
+
+    public:
+        PerfProfiler();
+        void enable();
+        bool isEnabled() const;
+        PerfCounters& threadCounters();
+        void record(const char* stage, double time_ms, int64 pixels, const int64 counts[PERF_EVENTS]);
+        vector<StageProfile> getStages();
+        void printReport();
+};
+
+PerfProfiler& perfProfiler();
+
+// Profiles the enclosing scope as one call of a stage over the given number of pixels
+class PerfScope
+{
+    private:
+        const char* stage;
+        int64 pixels;
+        PerfCounters* counters;
+        int64 start_ticks;
+        int64 start_counts[PERF_EVENTS];
+
+        PerfScope(const PerfScope&);
+        PerfScope& operator=(const PerfScope&);
+
+    public:
+        PerfScope(const char* _stage, int64 _pixels);
+        ~PerfScope();
+};
+
+#endif
@@ -0,0 +1,139 @@
+/*
+ * A program to compare the landmarks written by MouthDetect and
+ * EyebrowDetect (-landmarks) against recorded golden outputs. For each
+ * pipeline it reports the landmark deviation in pixels and the change in
+ * pipeline time, and fails if any landmark moved beyond the tolerance.
+ *
+ */
+
+#include "opencv2/core/core.hpp"
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <map>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+using namespace cv;
+
+struct LandmarkRecord
+{
+    string pipeline;
+    double time_ms;
+    vector<Point> landmarks;
+};
+
+struct PipelineSummary
+{
+    int files;
+    int failures;
+    int compared;
+    double max_deviation;
+    double deviation_sum;
+    double golden_time;
+    double current_time;
+
+    PipelineSummary()
+        :files(0), failures(0), compared(0), max_deviation(0.0), deviation_sum(0.0), golden_time(0.0), current_time(0.0)
+    {
+    }
+};
+
+static bool readLandmarks(const string&, LandmarkRecord&);
+static string baseName(const string&);
+
+int main(int argc, char** argv)
+{
+    if(argc < 3)
+    {
+        cout << "USAGE: ./CompareLandmarks [GOLDEN_DIR] [OUTPUT_DIR] [TOLERANCE]\n"
+            "TOLERANCE\n\tLargest accepted landmark deviation in pixels (default: 0).\n";
+        return 1;
+    }
+
+    const string golden_dir = argv[1];
+    const string output_dir = argv[2];
+    double tolerance = (argc > 3) ? atof(argv[3]) : 0.0;
+
+    vector<string> golden_files;
+    glob(golden_dir + "/*.yml", golden_files);
+    if(golden_files.empty())
+    {
+        cout << "No golden outputs found in " << golden_dir << "\n";
+        return 1;
+    }
+
+    map<string, PipelineSummary> summaries;
+    bool passed = true;
+    for(unsigned int i = 0; i < golden_files.size(); ++i)
+    {
+        LandmarkRecord golden, current;
+        string current_path = output_dir + "/" + baseName(golden_files[i]);
+        if(!readLandmarks(golden_files[i], golden))
+            continue;
+
+        PipelineSummary& summary = summaries[golden.pipeline];
+        ++summary.files;
+        if(!readLandmarks(current_path, current) || current.landmarks.size() != golden.landmarks.size())
+        {
+            cout << "FAIL " << baseName(golden_files[i]) << ": landmarks missing or of a different count\n";
+            ++summary.failures;
+            passed = false;
+            continue;
+        }
+
+        double deviation = 0.0;
+        for(unsigned int j = 0; j < golden.landmarks.size(); ++j)
+        {
+            double dx = current.landmarks[j].x - golden.landmarks[j].x;
+            double dy = current.landmarks[j].y - golden.landmarks[j].y;
+            deviation = max(deviation, sqrt(dx * dx + dy * dy));
+        }
+        if(deviation > tolerance)
+        {
+            cout << "FAIL " << baseName(golden_files[i]) << ": landmarks moved by " << deviation << " px\n";
+            ++summary.failures;
+            passed = false;
+        }
+
+        // Files beyond the tolerance still count towards the mean deviation
+        ++summary.compared;
+        summary.max_deviation = max(summary.max_deviation, deviation);
+        summary.deviation_sum += deviation;
+        summary.golden_time += golden.time_ms;
+        summary.current_time += current.time_ms;
+    }
+
+    printf("\npipeline\tfiles\tfailures\tmax_dev\tmean_dev\tgolden_ms\tcurrent_ms\tdelta\n");
+    for(map<string, PipelineSummary>::iterator it = summaries.begin(); it != summaries.end(); ++it)
+    {
+        const PipelineSummary& s = it->second;
+        printf("%s\t%d\t%d\t%.2f\t%.2f\t%.3f\t%.3f\t%+.1f%%\n", it->first.c_str(), s.files, s.failures,
+                s.max_deviation, (s.compared > 0) ? s.deviation_sum / s.compared : 0.0, s.golden_time,
+                s.current_time, (s.golden_time > 0.0) ? 100.0 * (s.current_time / s.golden_time - 1.0) : 0.0);
+    }
+    return passed ? 0 : 1;
+}
+
+static bool readLandmarks(const string& path, LandmarkRecord& record)
+{
+    FileStorage fs(path, FileStorage::READ);
+    if(!fs.isOpened())
+        return false;
+
+    record.pipeline = (string)fs["pipeline"];
+    record.time_ms = (double)fs["time_ms"];
+    FileNode landmarks = fs["landmarks"];
+    for(int k = 0; k + 1 < (int)landmarks.size(); k += 2)
+        record.landmarks.push_back(Point((int)landmarks[k], (int)landmarks[k+1]));
+    return true;
+}
+
+static string baseName(const string& path)
+{
+    size_t slash = path.find_last_of("/\\");
+    return (slash == string::npos) ? path : path.substr(slash + 1);
+}
@@ -0,0 +1,202 @@
+/*
+ * A program to validate the fixed-point pseudo-hue and threshold path of
+ * MouthDetect (-fixed) over a directory of mouth ROIs. Every ROI is run
+ * through the double and the fixed-point path; the worst-case deviation
+ * of the pseudo-hue plane is reported together with every ROI on which
+ * the threshold level, the binary mask or the lip contour differ.
+ * Planes whose mean + 0.9 * std_dev is an exact integer are checked
+ * separately, since that is where the two threshold paths could split.
+ *
+ */
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+#include "pixel_kernels.h"
+
+#include <iostream>
+#include <cstdio>
+#include <vector>
+
+using namespace std;
+using namespace cv;
+
+// Deviation guaranteed by the error bound of transformPseudoHueFixedT() for mouth ROIs
+static const int MAX_HUE_DEVIATION = 1;
+
+struct PathOutput
+{
+    Mat_<uchar> pseudo_hue;
+    int threshold_level;
+    Mat_<uchar> binary;
+    vector<Point> contour;
+};
+
+static vector<Point> largestContour(const Mat_<uchar>& binary)
+{
+    // A clone image is required because findContours() modifies the input image
+    Mat binary_clone = binary.clone();
+    vector<vector<Point> > contours;
+    findContours(binary_clone, contours, CV_RETR_LIST, CV_CHAIN_APPROX_NONE);
+
+    int largest_contour_idx = -1;
+    size_t largest_contour_size = 0;
+    for(size_t i = 0; i < contours.size(); ++i)
+    {
+        if(contours[i].size() > largest_contour_size)
+        {
+            largest_contour_size = contours[i].size();
+            largest_contour_idx = (int)i;
+        }
+    }
+    return (largest_contour_idx < 0) ? vector<Point>() : contours[largest_contour_idx];
+}
+
+static int countDifferences(const Mat_<uchar>& a, const Mat_<uchar>& b)
+{
+    int differences = 0;
+    for(int i = 0; i < a.rows; ++i)
+    {
+        for(int j = 0; j < a.cols; ++j)
+        {
+            if(a(i, j) != b(i, j))
+                ++differences;
+        }
+    }
+    return differences;
+}
+
+/*
+ * Two-level planes (half low, half high) have mean (low + high) / 2 and
+ * std_dev (high - low) / 2, so the pairs below put mean + 0.9 * std_dev
+ * exactly on a level: 19, 29, 59, 190, and 0, 1, 7 for flat planes. Both
+ * threshold paths must count that level as foreground (levels 0 and 1
+ * only strictly above it). Returns the number of pairs that differ.
+ */
+static int checkIntegerThresholds()
+{
+    const int pairs[][2] = { {0, 20}, {10, 30}, {40, 60}, {0, 200}, {0, 0}, {1, 1}, {7, 7} };
+    const int pair_count = sizeof(pairs) / sizeof(pairs[0]);
+
+    int differences = 0;
+    for(int n = 0; n < pair_count; ++n)
+    {
+        Mat_<uchar> plane(8, 16);
+        for(int i = 0; i < plane.rows; ++i)
+        {
+            for(int j = 0; j < plane.cols; ++j)
+                plane(i, j) = (uchar)((j < plane.cols / 2) ? pairs[n][0] : pairs[n][1]);
+        }
+
+        Histogram hist(plane);
+        int reference = thresholdMeanStd(hist, 0.9);
+        int fixed = thresholdMeanStdFixed(hist);
+        if(fixed != reference)
+        {
+            cout << "levels " << pairs[n][0] << "/" << pairs[n][1] << ": threshold level " << fixed
+                << " instead of " << reference << "\n";
+            ++differences;
+        }
+    }
+    return differences;
+}
+
+static void runPath(const Mat_<Vec3b>& mouth, bool fixed_point, PathOutput& output, double& time_ms)
+{
+    Histogram hist;
+    double t = (double)getTickCount();
+    if(fixed_point)
+    {
+        output.pseudo_hue = transformPseudoHueFixedT<LayoutBGR>(mouth, &hist);
+        output.threshold_level = thresholdMeanStdFixed(hist);
+    }
+    else
+    {
+        output.pseudo_hue = transformPseudoHueT<LayoutBGR, uchar>(mouth, &hist);
+        output.threshold_level = thresholdMeanStd(hist, 0.9);
+    }
+    output.binary = applyThreshold(output.pseudo_hue, output.threshold_level);
+    time_ms += ((double)getTickCount() - t) / getTickFrequency() * 1000;
+
+    output.contour = largestContour(output.binary);
+}
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        cout << "USAGE: ./FixedPointCheck [ROI_DIR] [PATTERN]\n"
+            "PATTERN\n\tFile name pattern of the mouth ROIs (default: *.png).\n";
+        return 1;
+    }
+
+    const string pattern = (argc > 2) ? argv[2] : "*.png";
+    vector<string> files;
+    glob(string(argv[1]) + "/" + pattern, files);
+    if(files.empty())
+    {
+        cerr << "No regions found in " << argv[1] << "\n";
+        return 1;
+    }
+
+    int regions = 0, max_deviation = 0, hue_mismatches = 0;
+    int threshold_differences = 0, binary_differences = 0, contour_differences = 0;
+    long total_pixels = 0;
+    string worst_file;
+    double time_double = 0.0, time_fixed = 0.0;
+    for(size_t f = 0; f < files.size(); ++f)
+    {
+        Mat_<Vec3b> mouth = imread(files[f]);
+        if(mouth.empty())
+            continue;
+        ++regions;
+        total_pixels += (long)mouth.total();
+
+        PathOutput reference, fixed;
+        runPath(mouth, false, reference, time_double);
+        runPath(mouth, true, fixed, time_fixed);
+
+        int deviation = (int)norm(reference.pseudo_hue, fixed.pseudo_hue, NORM_INF);
+        hue_mismatches += countDifferences(reference.pseudo_hue, fixed.pseudo_hue);
+        if(deviation > max_deviation)
+        {
+            max_deviation = deviation;
+            worst_file = files[f];
+        }
+        if(deviation > MAX_HUE_DEVIATION)
+            cout << files[f] << ": pseudo-hue differs by " << deviation << " levels\n";
+
+        if(fixed.threshold_level != reference.threshold_level)
+        {
+            cout << files[f] << ": threshold level " << fixed.threshold_level << " instead of "
+                << reference.threshold_level << "\n";
+            ++threshold_differences;
+        }
+
+        int binary_mismatches = countDifferences(reference.binary, fixed.binary);
+        if(binary_mismatches > 0)
+        {
+            cout << files[f] << ": " << binary_mismatches << " pixels of the binary mask differ\n";
+            ++binary_differences;
+        }
+
+        if(fixed.contour != reference.contour)
+        {
+            cout << files[f] << ": lip contour differs (" << fixed.contour.size() << " instead of "
+                << reference.contour.size() << " points)\n";
+            ++contour_differences;
+        }
+    }
+
+    printf("\nregions\tmax_dev\tpixels_differ\tthreshold_diff\tbinary_diff\tcontour_diff\tdouble_ms\tfixed_ms\n");
+    printf("%d\t%d\t%d/%ld\t%d\t%d\t%d\t%.3f\t%.3f\n", regions, max_deviation, hue_mismatches, total_pixels,
+            threshold_differences, binary_differences, contour_differences, time_double, time_fixed);
+    if(!worst_file.empty())
+        cout << "Worst-case pseudo-hue deviation on " << worst_file << "\n";
+
+    int integer_differences = checkIntegerThresholds();
+    cout << "Integer mean + 0.9 * std_dev thresholds: " << integer_differences << " differ\n";
+
+    return (max_deviation > MAX_HUE_DEVIATION || integer_differences > 0) ? 1 : 0;
+}
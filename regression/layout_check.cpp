@@ -0,0 +1,169 @@
+/*
+ * A program to check that every specialisation of the pixel kernels in
+ * kernels/ agrees with the BGR, 8-bit path used by MouthDetect and
+ * EyebrowDetect. Each region is converted to RGB, BGRA and NV12 and the
+ * kernels are run on the native buffers and at 16-bit and float depth.
+ *
+ */
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+#include "pixel_kernels.h"
+
+#include <iostream>
+#include <cstdio>
+#include <vector>
+
+using namespace std;
+using namespace cv;
+
+static const int KERNELS = 4;
+static const char* KERNEL_NAMES[KERNELS] = {"CR", "pseudo-hue", "LUX", "modified LUX"};
+
+// The pseudo-hue kernel rounds from a 0-1 value, one level is accepted across depths
+static const int KERNEL_DEPTH_TOLERANCE[KERNELS] = {0, 1, 0, 0};
+
+struct VariantSummary
+{
+    string name;
+    bool across_depth;
+    int failures;
+    double time_ms;
+};
+
+static Mat toNV12(const Mat& image_BGR);
+
+// Rescale a kernel output to the 0-255 range of the 8-bit path
+template<typename OutT>
+static Mat toByteScale(const Mat_<OutT>& plane)
+{
+    Mat bytes;
+    plane.convertTo(bytes, CV_8U, 255.0 / DepthTraits<OutT>::fromByte(255));
+    return bytes;
+}
+
+template<class Layout, typename OutT>
+static void runKernels(const Mat& frame, vector<Mat>& planes, double& time_ms)
+{
+    double t = (double)getTickCount();
+    Mat_<OutT> cr = CRTransformT<Layout, OutT>(frame);
+    Mat_<OutT> pseudo_hue = transformPseudoHueT<Layout, OutT>(frame, NULL);
+    Mat_<OutT> lux = transformLUXT<Layout, OutT>(frame);
+    Mat_<OutT> modified_lux = transformModifiedLUXT<Layout, OutT>(frame);
+    time_ms += ((double)getTickCount() - t) / getTickFrequency() * 1000;
+
+    planes.clear();
+    planes.push_back(toByteScale(cr));
+    planes.push_back(toByteScale(pseudo_hue));
+    planes.push_back(toByteScale(lux));
+    planes.push_back(toByteScale(modified_lux));
+}
+
+static void compareVariant(const string& file, const vector<Mat>& planes, const vector<Mat>& reference, VariantSummary& summary)
+{
+    for(int k = 0; k < KERNELS; ++k)
+    {
+        double deviation = norm(planes[k], reference[k], NORM_INF);
+        int tolerance = summary.across_depth ? KERNEL_DEPTH_TOLERANCE[k] : 0;
+        if(deviation > tolerance)
+        {
+            cout << file << ": " << summary.name << " " << KERNEL_NAMES[k] << " differs by " << deviation << " levels\n";
+            ++summary.failures;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        cout << "USAGE: ./LayoutCheck [DATA_DIR]\n";
+        return 1;
+    }
+
+    vector<string> files;
+    glob(string(argv[1]) + "/*.png", files);
+    if(files.empty())
+    {
+        cerr << "No regions found in " << argv[1] << "\n";
+        return 1;
+    }
+
+    const char* names[] = {"BGR/8U", "RGB/8U", "BGRA/8U", "NV12/8U", "BGR/16U", "BGR/32F"};
+    vector<VariantSummary> summaries(6);
+    for(size_t v = 0; v < summaries.size(); ++v)
+    {
+        summaries[v].name = names[v];
+        summaries[v].across_depth = (v >= 4);
+        summaries[v].failures = 0;
+        summaries[v].time_ms = 0.0;
+    }
+
+    for(size_t f = 0; f < files.size(); ++f)
+    {
+        Mat image_BGR = imread(files[f]);
+        if(image_BGR.empty())
+            continue;
+
+        // NV12 needs even dimensions
+        image_BGR = image_BGR(Rect(0, 0, image_BGR.cols & ~1, image_BGR.rows & ~1)).clone();
+
+        Mat image_RGB, image_BGRA, image_NV12_BGR;
+        cvtColor(image_BGR, image_RGB, CV_BGR2RGB);
+        cvtColor(image_BGR, image_BGRA, CV_BGR2BGRA);
+        Mat image_NV12 = toNV12(image_BGR);
+        cvtColor(image_NV12, image_NV12_BGR, CV_YUV2BGR_NV12);
+
+        vector<Mat> reference, nv12_reference, planes;
+        runKernels<LayoutBGR, uchar>(image_BGR, reference, summaries[0].time_ms);
+
+        runKernels<LayoutRGB, uchar>(image_RGB, planes, summaries[1].time_ms);
+        compareVariant(files[f], planes, reference, summaries[1]);
+
+        runKernels<LayoutBGRA, uchar>(image_BGRA, planes, summaries[2].time_ms);
+        compareVariant(files[f], planes, reference, summaries[2]);
+
+        // NV12 is lossy, compare against the BGR path on the decoded frame
+        double untimed = 0.0;
+        runKernels<LayoutBGR, uchar>(image_NV12_BGR, nv12_reference, untimed);
+        runKernels<LayoutNV12, uchar>(image_NV12, planes, summaries[3].time_ms);
+        compareVariant(files[f], planes, nv12_reference, summaries[3]);
+
+        runKernels<LayoutBGR, ushort>(image_BGR, planes, summaries[4].time_ms);
+        compareVariant(files[f], planes, reference, summaries[4]);
+
+        runKernels<LayoutBGR, float>(image_BGR, planes, summaries[5].time_ms);
+        compareVariant(files[f], planes, reference, summaries[5]);
+    }
+
+    int failures = 0;
+    printf("%-10s %10s %12s\n", "variant", "failures", "time (ms)");
+    for(size_t v = 0; v < summaries.size(); ++v)
+    {
+        printf("%-10s %10d %12.2f\n", summaries[v].name.c_str(), summaries[v].failures, summaries[v].time_ms);
+        failures += summaries[v].failures;
+    }
+
+    return (failures > 0) ? 1 : 0;
+}
+
+// Interleave the chroma planes of an I420 conversion into NV12
+static Mat toNV12(const Mat& image_BGR)
+{
+    Mat image_I420;
+    cvtColor(image_BGR, image_I420, CV_BGR2YUV_I420);
+
+    int rows = image_BGR.rows, cols = image_BGR.cols;
+    Mat image_NV12 = image_I420.clone();
+    const uchar* U = image_I420.ptr(rows);
+    const uchar* V = U + (rows / 2) * (cols / 2);
+    uchar* UV = image_NV12.ptr(rows);
+    for(int i = 0; i < (rows / 2) * (cols / 2); ++i)
+    {
+        UV[2 * i] = U[i];
+        UV[2 * i + 1] = V[i];
+    }
+    return image_NV12;
+}
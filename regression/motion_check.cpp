@@ -0,0 +1,120 @@
+/*
+ * A program to check the block-wise change detection of MotionGate
+ * (motion/) on synthetic frames: an unchanged frame or sensor noise below
+ * the threshold must leave every block static, a moved patch must mark
+ * the blocks under it (and only those) as changed for settle_frames more
+ * frames, and the periodic refresh must mark the whole frame.
+ *
+ */
+
+#include "opencv2/core/core.hpp"
+
+#include "motion_gate.h"
+
+#include <iostream>
+#include <cstdio>
+
+using namespace std;
+using namespace cv;
+
+static int failures = 0;
+
+static void expect(bool condition, const string& description)
+{
+    cout << (condition ? "PASS " : "FAIL ") << description << "\n";
+    if(!condition)
+        ++failures;
+}
+
+// Textured background, so that moving a patch changes the pixels under it
+static Mat_<uchar> texturedFrame(RNG& rng, Size size)
+{
+    Mat_<uchar> frame(size);
+    for(int i = 0; i < frame.rows; ++i)
+    {
+        for(int j = 0; j < frame.cols; ++j)
+            frame(i, j) = (uchar)rng.uniform(0, 256);
+    }
+    return frame;
+}
+
+static Mat_<uchar> addNoise(RNG& rng, const Mat_<uchar>& frame, int amplitude)
+{
+    Mat_<uchar> noisy = frame.clone();
+    for(int i = 0; i < noisy.rows; ++i)
+    {
+        for(int j = 0; j < noisy.cols; ++j)
+            noisy(i, j) = saturate_cast<uchar>(frame(i, j) + rng.uniform(-amplitude, amplitude + 1));
+    }
+    return noisy;
+}
+
+int main()
+{
+    RNG rng(0x5EED);
+    MotionParams params;
+    params.refresh_interval = 20;
+    MotionGate motion_gate(params);
+
+    // 20 x 15 blocks of 16 pixels, plus a partial column and row of blocks
+    Size frame_size(330, 245);
+    Rect_<int> full_frame(0, 0, frame_size.width, frame_size.height);
+    Mat_<uchar> background = texturedFrame(rng, frame_size);
+
+    expect(motion_gate.update(background) && motion_gate.isRefresh(), "the first frame is a full refresh");
+
+    expect(!motion_gate.update(background), "an unchanged frame reports no change");
+    expect(motion_gate.isStatic(full_frame), "an unchanged frame leaves every block static");
+    expect(motion_gate.changedRegion().area() == 0, "an unchanged frame has an empty changed region");
+
+    expect(!motion_gate.update(addNoise(rng, background, params.threshold / 2)),
+            "noise below the threshold reports no change");
+
+    // Shift a 24 x 24 patch of the frame 8 pixels to the right
+    Mat_<uchar> shifted = background.clone();
+    Rect_<int> patch(100, 60, 24, 24);
+    Rect_<int> moved(patch.x + 8, patch.y, patch.width, patch.height);
+    Mat shifted_patch = shifted(moved);
+    background(patch).copyTo(shifted_patch);
+
+    expect(motion_gate.update(shifted) && !motion_gate.isRefresh(), "a shifted patch reports a change");
+    expect(!motion_gate.isStatic(moved), "the blocks under the shifted patch are not static");
+    expect(motion_gate.isStatic(Rect_<int>(0, 160, 96, 80)), "blocks away from the patch stay static");
+    Rect_<int> changed_region = motion_gate.changedRegion();
+    expect((changed_region & moved) == moved && changed_region.width <= 48 && changed_region.height <= 48,
+            "the changed region covers the patch and no more than its blocks");
+
+    bool settling = true;
+    for(int i = 0; i < params.settle_frames; ++i)
+    {
+        settling = settling && motion_gate.update(shifted) && !motion_gate.isStatic(moved) &&
+            motion_gate.isStatic(Rect_<int>(0, 160, 96, 80)) && (motion_gate.changedRegion() == changed_region);
+    }
+    expect(settling, "the blocks under the patch stay marked for settle_frames frames");
+    expect(!motion_gate.update(shifted), "the shifted frame is then the new reference");
+
+    // Invert the partial block in the bottom right corner (10 x 5 pixels)
+    Mat_<uchar> edge = shifted.clone();
+    Rect_<int> corner(320, 240, frame_size.width - 320, frame_size.height - 240);
+    for(int i = corner.y; i < corner.y + corner.height; ++i)
+    {
+        for(int j = corner.x; j < corner.x + corner.width; ++j)
+            edge(i, j) = (uchar)(255 - edge(i, j));
+    }
+    expect(motion_gate.update(edge) && !motion_gate.isStatic(corner), "a change in the partial corner block is detected");
+    expect(motion_gate.isStatic(Rect_<int>(0, 0, 320, 240)), "the full blocks stay static");
+
+    bool refreshed = false;
+    for(int i = 0; i < params.refresh_interval && !refreshed; ++i)
+    {
+        motion_gate.update(edge);
+        refreshed = motion_gate.isRefresh();
+    }
+    expect(refreshed && !motion_gate.isStatic(full_frame), "refresh_interval forces a full refresh");
+
+    MotionStats stats = motion_gate.getStats();
+    expect(stats.refreshes == 2, "two full refreshes are counted");
+
+    motion_gate.printStats();
+    return (failures > 0) ? 1 : 0;
+}
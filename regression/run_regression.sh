@@ -0,0 +1,68 @@
+#!/bin/sh
+#
+# Golden-output regression run for the mouth and eyebrow pixel pipelines.
+#
+# USAGE: ./run_regression.sh [record|check] [MOUTH_DETECT] [EYEBROW_DETECT] [REGRESSION_BIN_DIR] [OPTIONS]...
+#
+# record : (re)generate the golden landmarks in golden/ with the given binaries;
+#          run it on the reference build and commit golden/
+# check  : run the binaries again and compare against golden/, then check
+#          that all layout/depth specialisations of the kernels agree and
+#          that the fixed-point mouth path stays within one level and that
+#          the motion gate tells static from changed blocks
+# OPTIONS are passed on to both detection programs (e.g. -fixed, -otsu).
+#
+# The synthetic regions are regenerated into data/ on every run, so a
+# changed SyntheticRegions never leaves stale inputs behind.
+
+set -e
+
+if [ $# -lt 4 ]; then
+    sed -n '4,16p' "$0"
+    exit 1
+fi
+
+MODE=$1
+MOUTH_DETECT=$2
+EYEBROW_DETECT=$3
+BIN_DIR=$4
+shift 4
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+DATA_DIR=$HERE/data
+GOLDEN_DIR=$HERE/golden
+OUTPUT_DIR=$HERE/output
+
+if [ "$MODE" != "record" ] && ! ls "$GOLDEN_DIR"/*.yml > /dev/null 2>&1; then
+    echo "No golden outputs in $GOLDEN_DIR, run record on the reference build first"
+    exit 1
+fi
+
+rm -rf "$DATA_DIR"
+mkdir -p "$DATA_DIR"
+"$BIN_DIR/SyntheticRegions" "$DATA_DIR"
+
+if [ "$MODE" = "record" ]; then
+    TARGET_DIR=$GOLDEN_DIR
+else
+    TARGET_DIR=$OUTPUT_DIR
+fi
+rm -rf "$TARGET_DIR"
+mkdir -p "$TARGET_DIR"
+
+# Cascades are not needed with -roi, the positional arguments are placeholders
+for image in "$DATA_DIR"/mouth_*.png; do
+    name=$(basename "$image" .png)
+    "$MOUTH_DETECT" "$image" none -roi -landmarks "$TARGET_DIR/$name.yml" "$@" || true
+done
+for image in "$DATA_DIR"/eyebrow_*.png; do
+    name=$(basename "$image" .png)
+    "$EYEBROW_DETECT" "$image" none none -roi -landmarks "$TARGET_DIR/$name.yml" "$@" > /dev/null || true
+done
+
+if [ "$MODE" = "check" ]; then
+    "$BIN_DIR/CompareLandmarks" "$GOLDEN_DIR" "$OUTPUT_DIR" "${TOLERANCE:-0}"
+    "$BIN_DIR/LayoutCheck" "$DATA_DIR"
+    "$BIN_DIR/FixedPointCheck" "$DATA_DIR" "mouth_*.png"
+    "$BIN_DIR/MotionCheck"
+fi
@@ -0,0 +1,130 @@
+/*
+ * A program to generate synthetic mouth and eyebrow regions for the
+ * regression harness. The images are drawn from a fixed seed, so the
+ * same set is produced on every machine and no image data needs to be
+ * kept in the repository. Every random draw is a statement of its own,
+ * because the evaluation order of function arguments is unspecified.
+ *
+ */
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+using namespace cv;
+
+static Mat_<Vec3b> skinBackground(RNG& rng, Size size);
+static void addNoise(RNG& rng, Mat_<Vec3b>& image, double sigma);
+static Mat_<Vec3b> synthesizeMouth(RNG& rng);
+static Mat_<Vec3b> synthesizeEyebrow(RNG& rng);
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        cout << "USAGE: ./SyntheticRegions [OUTPUT_DIR] [COUNT]\n";
+        return 1;
+    }
+
+    const string output_dir = argv[1];
+    int count = (argc > 2) ? atoi(argv[2]) : 32;
+
+    RNG rng(0x5EED);
+    char name[64];
+    for(int i = 0; i < count; ++i)
+    {
+        sprintf(name, "/mouth_%03d.png", i);
+        if(!imwrite(output_dir + name, synthesizeMouth(rng)))
+        {
+            cout << "Unable to write " << output_dir + name << "\n";
+            return 1;
+        }
+
+        sprintf(name, "/eyebrow_%03d.png", i);
+        if(!imwrite(output_dir + name, synthesizeEyebrow(rng)))
+        {
+            cout << "Unable to write " << output_dir + name << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static Mat_<Vec3b> skinBackground(RNG& rng, Size size)
+{
+    int B = rng.uniform(100, 140);
+    int G = rng.uniform(135, 165);
+    int R = rng.uniform(185, 225);
+    return Mat_<Vec3b>(size, Vec3b(B, G, R));
+}
+
+static void addNoise(RNG& rng, Mat_<Vec3b>& image, double sigma)
+{
+    for(int i = 0; i < image.rows; ++i)
+    {
+        for(int j = 0; j < image.cols; ++j)
+        {
+            for(int k = 0; k < 3; ++k)
+                image(i, j)[k] = saturate_cast<uchar>(image(i, j)[k] + rng.gaussian(sigma));
+        }
+    }
+}
+
+// Lower quarter of a face: skin with a pair of red lips, possibly parted
+static Mat_<Vec3b> synthesizeMouth(RNG& rng)
+{
+    int width = rng.uniform(100, 160);
+    int height = rng.uniform(50, 80);
+    Mat_<Vec3b> image = skinBackground(rng, Size(width, height));
+
+    int center_x = width / 2 + rng.uniform(-8, 9);
+    int center_y = height / 2 + rng.uniform(-5, 6);
+    int lips_width = rng.uniform(width / 4, width / 3);
+    int lips_height = rng.uniform(height / 8, height / 5);
+    int lip_B = rng.uniform(70, 100);
+    int lip_G = rng.uniform(60, 90);
+    int lip_R = rng.uniform(160, 200);
+    double angle = rng.uniform(-6.0, 6.0);
+    Point center(center_x, center_y);
+    Size lips(lips_width, lips_height);
+    ellipse(image, center, lips, angle, 0, 360, Scalar(lip_B, lip_G, lip_R), -1, CV_AA);
+
+    if(rng.uniform(0, 2) == 1)
+    {
+        Size opening(lips.width * 3 / 4, max(lips.height / 4, 1));
+        ellipse(image, center, opening, 0, 0, 360, Scalar(40, 35, 60), -1, CV_AA);
+    }
+
+    GaussianBlur(image, image, Size(3, 3), 0);
+    addNoise(rng, image, 4.0);
+    return image;
+}
+
+// Region above an eye: skin with a dark eyebrow arc
+static Mat_<Vec3b> synthesizeEyebrow(RNG& rng)
+{
+    int width = rng.uniform(80, 130);
+    int height = rng.uniform(30, 50);
+    Mat_<Vec3b> image = skinBackground(rng, Size(width, height));
+
+    int center_x = width / 2 + rng.uniform(-6, 7);
+    int center_y = height * 3 / 4 + rng.uniform(-3, 4);
+    int arc_width = width * 2 / 5 + rng.uniform(-5, 6);
+    int arc_height = height / 2 + rng.uniform(-3, 4);
+    int brow_B = rng.uniform(30, 60);
+    int brow_G = rng.uniform(35, 65);
+    int brow_R = rng.uniform(45, 80);
+    double angle = rng.uniform(-8.0, 8.0);
+    int thickness = rng.uniform(4, 8);
+    ellipse(image, Point(center_x, center_y), Size(arc_width, arc_height), angle, 200, 340,
+            Scalar(brow_B, brow_G, brow_R), thickness, CV_AA);
+
+    GaussianBlur(image, image, Size(3, 3), 0);
+    addNoise(rng, image, 4.0);
+    return image;
+}
@@ -0,0 +1,231 @@
+#ifndef _HISTOGRAM_THRESHOLD_CPP
+#define _HISTOGRAM_THRESHOLD_CPP
+
+#include <cmath>
+#include <limits>
+#include "histogram_threshold.h"
+using namespace std;
+using namespace cv;
+
+Histogram::Histogram()
+{
+    clear();
+}
+
+Histogram::Histogram(const Mat_<uchar>& image)
+{
+    clear();
+    addImage(image);
+}
+
+void Histogram::clear()
+{
+    for(int b = 0; b < HISTOGRAM_BANKS; ++b)
+    {
+        for(int k = 0; k < HISTOGRAM_LEVELS; ++k)
+            banks[b][k] = 0;
+    }
+}
+
+void Histogram::addRow(const uchar* row, int cols)
+{
+    int j = 0;
+    for(; j + HISTOGRAM_BANKS <= cols; j += HISTOGRAM_BANKS)
+    {
+        ++banks[0][row[j]];
+        ++banks[1][row[j+1]];
+        ++banks[2][row[j+2]];
+        ++banks[3][row[j+3]];
+    }
+    for(; j < cols; ++j)
+        ++banks[0][row[j]];
+}
+
+void Histogram::addImage(const Mat_<uchar>& image)
+{
+    for(int i = 0; i < image.rows; ++i)
+        addRow(image[i], image.cols);
+}
+
+void Histogram::levels(int64* counts) const
+{
+    for(int k = 0; k < HISTOGRAM_LEVELS; ++k)
+    {
+        counts[k] = 0;
+        for(int b = 0; b < HISTOGRAM_BANKS; ++b)
+            counts[k] += banks[b][k];
+    }
+}
+
+int64 Histogram::total() const
+{
+    int64 counts[HISTOGRAM_LEVELS];
+    levels(counts);
+
+    int64 total_pixels = 0;
+    for(int k = 0; k < HISTOGRAM_LEVELS; ++k)
+        total_pixels += counts[k];
+    return total_pixels;
+}
+
+// Mean and standard deviation, exact up to the final division
+pair<double, double> Histogram::stats() const
+{
+    int64 counts[HISTOGRAM_LEVELS];
+    levels(counts);
+
+    int64 total_pixels = 0, intensity_sum = 0, intensity_sum_sq = 0;
+    for(int k = 0; k < HISTOGRAM_LEVELS; ++k)
+    {
+        total_pixels += counts[k];
+        intensity_sum += counts[k] * k;
+        intensity_sum_sq += counts[k] * k * k;
+    }
+    if(total_pixels == 0)
+        return make_pair(0.0, 0.0);
+
+    double mean = (double)intensity_sum / total_pixels;
+    double variance = (double)intensity_sum_sq / total_pixels - (mean * mean);
+    return make_pair(mean, sqrt(max(variance, 0.0)));
+}
+
+int thresholdMeanStd(const Histogram& hist, double Z)
+{
+    pair<double, double> stats = hist.stats();
+    double threshold = stats.first + (Z * stats.second);
+
+    int level = cvCeil(threshold + numeric_limits<double>::epsilon());
+    return min(max(level, 0), HISTOGRAM_LEVELS);
+}
+
+/*
+ * Integer counterpart of thresholdMeanStd(hist, 0.9). For N pixels with
+ * sum S and sum of squares Q, p >= mean + 0.9 * std_dev is
+ * 10 * (N*p - S) >= 9 * sqrt(N*Q - S*S), which is decided exactly by the
+ * sign of N*p - S and 100 * (N*p - S)^2 >= 81 * (N*Q - S*S). Like the
+ * epsilon of thresholdMeanStd(), levels 0 and 1 must lie strictly above
+ * the threshold (the epsilon is absorbed into the threshold from 2 on).
+ * The 64-bit products hold for up to 2^20 pixels; larger (and empty)
+ * inputs take the double path.
+ */
+int thresholdMeanStdFixed(const Histogram& hist)
+{
+    int64 counts[HISTOGRAM_LEVELS];
+    hist.levels(counts);
+
+    int64 total_pixels = 0, intensity_sum = 0, intensity_sum_sq = 0;
+    for(int k = 0; k < HISTOGRAM_LEVELS; ++k)
+    {
+        total_pixels += counts[k];
+        intensity_sum += counts[k] * k;
+        intensity_sum_sq += counts[k] * k * k;
+    }
+    if(total_pixels == 0 || total_pixels >= (1 << 20))
+        return thresholdMeanStd(hist, 0.9);
+
+    int64 variance_scaled = 81 * ((total_pixels * intensity_sum_sq) - (intensity_sum * intensity_sum));
+    for(int p = 0; p < HISTOGRAM_LEVELS; ++p)
+    {
+        int64 deviation = (total_pixels * p) - intensity_sum;
+        int64 deviation_sq = 100 * deviation * deviation;
+        bool foreground = (p < 2) ? (deviation > 0 && deviation_sq > variance_scaled) :
+            (deviation >= 0 && deviation_sq >= variance_scaled);
+        if(foreground)
+            return p;
+    }
+    return HISTOGRAM_LEVELS;
+}
+
+int thresholdOtsu(const Histogram& hist)
+{
+    int64 counts[HISTOGRAM_LEVELS];
+    hist.levels(counts);
+
+    double total_pixels = 0.0, intensity_sum = 0.0;
+    for(int k = 0; k < HISTOGRAM_LEVELS; ++k)
+    {
+        total_pixels += counts[k];
+        intensity_sum += (double)counts[k] * k;
+    }
+
+    // Maximise the between-class variance over all split points
+    double background_count = 0.0, background_sum = 0.0;
+    double max_variance = -1.0;
+    int best_level = 0;
+    for(int k = 0; k < HISTOGRAM_LEVELS; ++k)
+    {
+        background_count += counts[k];
+        background_sum += (double)counts[k] * k;
+
+        double foreground_count = total_pixels - background_count;
+        if(background_count == 0.0 || foreground_count == 0.0)
+            continue;
+
+        double background_mean = background_sum / background_count;
+        double foreground_mean = (intensity_sum - background_sum) / foreground_count;
+        double variance = background_count * foreground_count *
+            (background_mean - foreground_mean) * (background_mean - foreground_mean);
+        if(variance > max_variance)
+        {
+            max_variance = variance;
+            best_level = k;
+        }
+    }
+    return best_level + 1;
+}
+
+int thresholdPercentile(const Histogram& hist, double percentile)
+{
+    int64 counts[HISTOGRAM_LEVELS];
+    hist.levels(counts);
+
+    double background_pixels = (percentile / 100.0) * hist.total();
+    int64 cumulative = 0;
+    for(int k = 0; k < HISTOGRAM_LEVELS; ++k)
+    {
+        if(cumulative >= background_pixels)
+            return k;
+        cumulative += counts[k];
+    }
+    return HISTOGRAM_LEVELS;
+}
+
+int computeThreshold(const Histogram& hist, ThresholdStrategy strategy, double param)
+{
+    switch(strategy)
+    {
+        case THRESHOLD_OTSU:
+            return thresholdOtsu(hist);
+        case THRESHOLD_PERCENTILE:
+            return thresholdPercentile(hist, param);
+        case THRESHOLD_MEAN_STD:
+        default:
+            return thresholdMeanStd(hist, param);
+    }
+}
+
+// Pixels at or above the given level become 255, the rest 0
+Mat_<uchar> applyThreshold(const Mat_<uchar>& image, int level)
+{
+    uchar binary_lut[HISTOGRAM_LEVELS];
+    for(int k = 0; k < HISTOGRAM_LEVELS; ++k)
+        binary_lut[k] = (k >= level) ? 255 : 0;
+
+    Mat_<uchar> image_binary(image.size());
+    for(int i = 0; i < image.rows; ++i)
+    {
+        const uchar* src = image[i];
+        uchar* dst = image_binary[i];
+        for(int j = 0; j < image.cols; ++j)
+            dst[j] = binary_lut[src[j]];
+    }
+    return image_binary;
+}
+
+Mat_<uchar> histogramThresholding(const Mat_<uchar>& image, ThresholdStrategy strategy, double param)
+{
+    Histogram hist(image);
+    return applyThreshold(image, computeThreshold(hist, strategy, param));
+}
+
+#endif
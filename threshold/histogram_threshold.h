@@ -0,0 +1,50 @@
+#ifndef _HISTOGRAM_THRESHOLD_H
+#define _HISTOGRAM_THRESHOLD_H
+
+#include "opencv2/core/core.hpp"
+
+using namespace std;
+using namespace cv;
+
+#define HISTOGRAM_LEVELS 256
+#define HISTOGRAM_BANKS 4
+
+enum ThresholdStrategy
+{
+    THRESHOLD_MEAN_STD,     // mean + Z * std_dev, Z given as parameter
+    THRESHOLD_OTSU,         // Otsu's method, parameter unused
+    THRESHOLD_PERCENTILE    // parameter is the percentage of pixels kept as background
+};
+
+/*
+ * 256-bin histogram of an 8-bit plane. Consecutive pixels are counted
+ * into separate banks so that runs of equal values do not serialise on
+ * the same counter; the banks are only merged when the counts are read.
+ */
+class Histogram
+{
+    private:
+        int banks[HISTOGRAM_BANKS][HISTOGRAM_LEVELS];
+
+    public:
+        Histogram();
+        explicit Histogram(const Mat_<uchar>& image);
+        void clear();
+        void addRow(const uchar* row, int cols);
+        void addImage(const Mat_<uchar>& image);
+        void levels(int64* counts) const;
+        int64 total() const;
+        pair<double, double> stats() const;
+};
+
+// Each strategy returns the smallest level counted as foreground (0 to 256)
+int thresholdMeanStd(const Histogram& hist, double Z);
+int thresholdMeanStdFixed(const Histogram& hist);   // all-integer thresholdMeanStd(hist, 0.9)
+int thresholdOtsu(const Histogram& hist);
+int thresholdPercentile(const Histogram& hist, double percentile);
+int computeThreshold(const Histogram& hist, ThresholdStrategy strategy, double param);
+
+Mat_<uchar> applyThreshold(const Mat_<uchar>& image, int level);
+Mat_<uchar> histogramThresholding(const Mat_<uchar>& image, ThresholdStrategy strategy, double param);
+
+#endif
@@ -0,0 +1,315 @@
+/*
+ * A program to tune the detectMultiScale() parameters of a cascade
+ * on a labeled image set. Every combination of scale factor, minimum
+ * neighbours and minimum/maximum object size is timed and scored for
+ * recall; the fastest combination that keeps the required recall is
+ * written to a tuning profile that the detection programs load with
+ * the -profile option.
+ *
+ */
+
+#include "opencv2/objdetect/objdetect.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+#include "cascade_profile.h"
+#include "tiled_detection.h"
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <climits>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+using namespace cv;
+
+// Functions to parse command-line arguments
+static string getCommandOption(const vector<string>&, const string&);
+static void setCommandOptions(vector<string>&, int, char**);
+static bool doesCmdOptionExist(const vector<string>& , const string&);
+
+struct LabeledImage
+{
+    string path;
+    Mat image;
+    vector<Rect_<int> > objects;
+};
+
+struct SweepResult
+{
+    CascadeParams params;
+    double ms_per_image;
+    double recall;
+    int false_positives;
+};
+
+static void help();
+static bool loadDataset(const string&, vector<LabeledImage>&);
+static SweepResult evaluate(CascadeClassifier&, const vector<LabeledImage>&, const CascadeParams&, int);
+static void printResult(const string&, const SweepResult&);
+static void addSizeCandidate(vector<int>&, int);
+
+int main(int argc, char** argv)
+{
+    if(argc < 5)
+    {
+        help();
+        return 1;
+    }
+
+    // Extract command-line options
+    vector<string> args;
+    setCommandOptions(args, argc, argv);
+
+    const string dataset_path = argv[1];
+    const string cascade_name = argv[2];
+    const string cascade_path = argv[3];
+    const string profile_path = argv[4];
+    int repeat = (doesCmdOptionExist(args, "-repeat")) ? atoi(getCommandOption(args, "-repeat").c_str()) : 1;
+    repeat = max(repeat, 1);
+
+    CascadeClassifier cascade;
+    if(!cascade.load(cascade_path))
+    {
+        cout << "Unable to load the cascade " << cascade_path << "\n";
+        return 1;
+    }
+
+    vector<LabeledImage> dataset;
+    if(!loadDataset(dataset_path, dataset) || dataset.empty())
+    {
+        cout << "Unable to read the labeled image set " << dataset_path << "\n";
+        return 1;
+    }
+
+    // Size range of the labeled objects drives the min/max size candidates
+    int smallest = INT_MAX, largest = 0;
+    for(unsigned int i = 0; i < dataset.size(); ++i)
+    {
+        for(unsigned int j = 0; j < dataset[i].objects.size(); ++j)
+        {
+            smallest = min(smallest, min(dataset[i].objects[j].width, dataset[i].objects[j].height));
+            largest = max(largest, max(dataset[i].objects[j].width, dataset[i].objects[j].height));
+        }
+    }
+    if(largest == 0)
+    {
+        cout << "The labeled image set contains no objects\n";
+        return 1;
+    }
+
+    // The defaults serve as the baseline; unless told otherwise, no recall may be lost
+    SweepResult baseline = evaluate(cascade, dataset, defaultCascadeParams(cascade_name), repeat);
+    double min_recall = (doesCmdOptionExist(args, "-min-recall")) ?
+        atof(getCommandOption(args, "-min-recall").c_str()) : baseline.recall;
+
+    cout << "setting\tscale\tneighbors\tmin_size\tmax_size\tms/image\trecall\tfalse_positives\n";
+    printResult("default", baseline);
+
+    const double scale_factors[] = { 1.05, 1.10, 1.15, 1.20, 1.25, 1.30 };
+    const int neighbors[] = { 2, 3, 4, 5, 6 };
+
+    /*
+     * A minimum size above the smallest labeled object, or a maximum size
+     * below the largest one, can only lose recall, so the size candidates
+     * bracket the labeled range from the outside: the built-in minimum of
+     * 30 pixels and four steps up to just below the smallest object, and
+     * no limit plus four steps down to just above the largest object.
+     */
+    const double min_fractions[] = { 0.5, 0.65, 0.8, 0.95 };
+    const double max_fractions[] = { 2.0, 1.5, 1.25, 1.1 };
+    vector<int> min_sizes, max_sizes;
+    addSizeCandidate(min_sizes, 30);
+    max_sizes.push_back(0);
+    for(int k = 0; k < 4; ++k)
+    {
+        addSizeCandidate(min_sizes, cvRound(min_fractions[k] * smallest));
+        addSizeCandidate(max_sizes, cvCeil(max_fractions[k] * largest));
+    }
+
+    SweepResult best = baseline;
+    bool found = (baseline.recall >= min_recall);
+    for(int s = 0; s < 6; ++s)
+    {
+        for(int n = 0; n < 5; ++n)
+        {
+            for(unsigned int a = 0; a < min_sizes.size(); ++a)
+            {
+                for(unsigned int b = 0; b < max_sizes.size(); ++b)
+                {
+                    if(max_sizes[b] != 0 && max_sizes[b] <= min_sizes[a])
+                        continue;
+
+                    CascadeParams params(scale_factors[s], neighbors[n], Size(min_sizes[a], min_sizes[a]),
+                            Size(max_sizes[b], max_sizes[b]));
+                    SweepResult result = evaluate(cascade, dataset, params, repeat);
+                    printResult("sweep", result);
+
+                    // Fastest setting that keeps the required recall; otherwise the best recall
+                    bool acceptable = (result.recall >= min_recall);
+                    if( (acceptable && (!found || result.ms_per_image < best.ms_per_image)) ||
+                            (!acceptable && !found && result.recall > best.recall) )
+                    {
+                        best = result;
+                        found = found || acceptable;
+                    }
+                }
+            }
+        }
+    }
+
+    if(!found)
+        cout << "\nNo setting reaches a recall of " << min_recall << ", keeping the best recall\n";
+    cout << "\nSelected for " << cascade_name << ":\n";
+    printResult("selected", best);
+
+    // Keep the entries of the other cascades if the profile already exists
+    CascadeProfile profile;
+    profile.load(profile_path);
+    profile.set(cascade_name, best.params);
+    if(!profile.save(profile_path))
+    {
+        cout << "Unable to write the tuning profile " << profile_path << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+void setCommandOptions(vector<string>& args, int argc, char** argv)
+{
+    for(int i = 1; i < argc; ++i)
+    {
+        args.push_back(argv[i]);
+    }
+    return;
+}
+
+string getCommandOption(const vector<string>& args, const string& opt)
+{
+    string answer;
+    vector<string>::const_iterator it = find(args.begin(), args.end(), opt);
+    if(it != args.end() && (++it != args.end()))
+        answer = *it;
+    return answer;
+}
+
+bool doesCmdOptionExist(const vector<string>& args, const string& opt)
+{
+    vector<string>::const_iterator it = find(args.begin(), args.end(), opt);
+    return (it != args.end());
+}
+
+static void help()
+{
+    cout << "\nThis program sweeps the detectMultiScale() parameters of a cascade over a labeled image set\n"
+        "and stores the fastest setting that keeps the required recall in a tuning profile.\n";
+
+    cout << "\nUSAGE: ./CascadeTuning [DATASET] [CASCADE_NAME] [CASCADE] [PROFILE] [OPTIONS]\n"
+        "DATASET\n\tFileStorage (YAML/XML) file listing the images and their labeled objects.\n"
+        "CASCADE_NAME\n\tOne of face, eyes, nose, mouth.\n"
+        "CASCADE\n\tPath to the cascade classifier being tuned.\n"
+        "PROFILE\n\tTuning profile to create or update.\n"
+        "OPTIONS:\n"
+        "\t-min-recall : Required recall (default: the recall of the default parameters).\n"
+        "\t-repeat : Number of timed runs per image (default: 1).\n";
+
+    cout << "\nDATASET format (eyes, nose and mouth sets should contain face crops):\n"
+        "images:\n"
+        "   - { path: \"face01.jpg\", objects: [ x, y, width, height, x, y, width, height ] }\n";
+}
+
+static bool loadDataset(const string& dataset_path, vector<LabeledImage>& dataset)
+{
+    FileStorage fs(dataset_path, FileStorage::READ);
+    if(!fs.isOpened())
+        return false;
+
+    FileNode images = fs["images"];
+    for(FileNodeIterator it = images.begin(); it != images.end(); ++it)
+    {
+        LabeledImage sample;
+        sample.path = (string)(*it)["path"];
+        sample.image = imread(sample.path);
+        if(sample.image.empty())
+        {
+            cout << "Skipping unreadable image " << sample.path << "\n";
+            continue;
+        }
+
+        FileNode objects = (*it)["objects"];
+        for(int k = 0; k + 3 < (int)objects.size(); k += 4)
+        {
+            sample.objects.push_back(Rect((int)objects[k], (int)objects[k+1],
+                        (int)objects[k+2], (int)objects[k+3]));
+        }
+        dataset.push_back(sample);
+    }
+    return true;
+}
+
+static SweepResult evaluate(CascadeClassifier& cascade, const vector<LabeledImage>& dataset,
+        const CascadeParams& params, int repeat)
+{
+    int total_objects = 0, matched_objects = 0, false_positives = 0;
+    int64 ticks = 0;
+    for(unsigned int i = 0; i < dataset.size(); ++i)
+    {
+        vector<Rect_<int> > detections;
+        for(int r = 0; r < repeat; ++r)
+        {
+            int64 start = getTickCount();
+            runCascade(cascade, dataset[i].image, detections, params);
+            ticks += getTickCount() - start;
+        }
+
+        // Greedily match every labeled object to an unused detection (IoU >= 0.5)
+        vector<bool> used(detections.size(), false);
+        for(unsigned int j = 0; j < dataset[i].objects.size(); ++j)
+        {
+            int best_idx = -1;
+            double best_overlap = 0.5;
+            for(unsigned int k = 0; k < detections.size(); ++k)
+            {
+                double o = overlapRatio(dataset[i].objects[j], detections[k]);
+                if(!used[k] && o >= best_overlap)
+                {
+                    best_overlap = o;
+                    best_idx = k;
+                }
+            }
+            if(best_idx >= 0)
+            {
+                used[best_idx] = true;
+                ++matched_objects;
+            }
+        }
+        total_objects += dataset[i].objects.size();
+        false_positives += count(used.begin(), used.end(), false);
+    }
+
+    SweepResult result;
+    result.params = params;
+    result.ms_per_image = (ticks * 1000.0 / getTickFrequency()) / (dataset.size() * repeat);
+    result.recall = (total_objects > 0) ? (double)matched_objects / total_objects : 0.0;
+    result.false_positives = false_positives;
+    return result;
+}
+
+// Sizes below one pixel and duplicates are skipped
+static void addSizeCandidate(vector<int>& sizes, int size)
+{
+    if(size > 0 && find(sizes.begin(), sizes.end(), size) == sizes.end())
+        sizes.push_back(size);
+    return;
+}
+
+static void printResult(const string& setting, const SweepResult& result)
+{
+    printf("%s\t%.2f\t%d\t%dx%d\t%dx%d\t%.3f\t%.3f\t%d\n", setting.c_str(), result.params.scale_factor,
+            result.params.min_neighbors, result.params.min_size.width, result.params.min_size.height,
+            result.params.max_size.width, result.params.max_size.height, result.ms_per_image,
+            result.recall, result.false_positives);
+}
@@ -0,0 +1,94 @@
+/*
+ * A program to compare a face detection backend against the Haar
+ * cascade on the same images: detection time per image for both, and
+ * how many of the Haar faces the backend finds as well (IoU >= 0.5).
+ *
+ */
+
+#include "opencv2/highgui/highgui.hpp"
+
+#include "cascade_profile.h"
+#include "face_detector.h"
+#include "tiled_detection.h"
+
+#include <iostream>
+#include <cstdio>
+#include <vector>
+
+using namespace std;
+using namespace cv;
+
+int main(int argc, char** argv)
+{
+    if(argc < 5)
+    {
+        cout << "USAGE: ./DetectorBenchmark [HAAR_CASCADE] [BACKEND] [MODEL] [IMAGE]...\n"
+            "BACKEND\n\tBackend compared against the Haar cascade (haar or lbp).\n"
+            "MODEL\n\tCascade file of that backend, e.g. lbpcascade_frontalface.xml.\n";
+        return 1;
+    }
+
+    Ptr<FaceDetector> reference = createFaceDetector("haar");
+    Ptr<FaceDetector> candidate = createFaceDetector(argv[2]);
+    if(!reference->load(argv[1]))
+    {
+        cout << "Unable to load " << argv[1] << " as a haar face detector\n";
+        return 1;
+    }
+    if(candidate.empty() || !candidate->load(argv[3]))
+    {
+        cout << "Unable to load " << argv[3] << " as a " << argv[2] << " face detector\n";
+        return 1;
+    }
+    CascadeParams face_params = defaultCascadeParams("face");
+
+    double reference_time = 0.0, candidate_time = 0.0;
+    int images = 0, reference_faces = 0, candidate_faces = 0, agreed_faces = 0;
+    for(int i = 4; i < argc; ++i)
+    {
+        Mat image = imread(argv[i]);
+        if(image.empty())
+        {
+            cout << "Skipping unreadable image " << argv[i] << "\n";
+            continue;
+        }
+        ++images;
+
+        vector<Rect_<int> > reference_result, candidate_result;
+        int64 start = getTickCount();
+        reference->detect(image, reference_result, face_params);
+        reference_time += (getTickCount() - start) * 1000.0 / getTickFrequency();
+
+        start = getTickCount();
+        candidate->detect(image, candidate_result, face_params);
+        candidate_time += (getTickCount() - start) * 1000.0 / getTickFrequency();
+
+        // Greedily match every Haar face to an unused face of the candidate
+        vector<bool> used(candidate_result.size(), false);
+        for(unsigned int j = 0; j < reference_result.size(); ++j)
+        {
+            for(unsigned int k = 0; k < candidate_result.size(); ++k)
+            {
+                if(!used[k] && overlapRatio(reference_result[j], candidate_result[k]) >= 0.5)
+                {
+                    used[k] = true;
+                    ++agreed_faces;
+                    break;
+                }
+            }
+        }
+        reference_faces += reference_result.size();
+        candidate_faces += candidate_result.size();
+    }
+    if(images == 0)
+        return 1;
+
+    printf("backend\tms/image\tfaces\n");
+    printf("%s\t%.3f\t%d\n", reference->name().c_str(), reference_time / images, reference_faces);
+    printf("%s\t%.3f\t%d\n", candidate->name().c_str(), candidate_time / images, candidate_faces);
+    printf("\nspeed-up: %.2fx\n", (candidate_time > 0.0) ? reference_time / candidate_time : 0.0);
+    printf("agreement: %d of %d haar faces found (%.1f%%), %d extra faces\n", agreed_faces,
+            reference_faces, (reference_faces > 0) ? 100.0 * agreed_faces / reference_faces : 100.0,
+            candidate_faces - agreed_faces);
+    return 0;
+}
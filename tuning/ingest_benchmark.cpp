@@ -0,0 +1,92 @@
+/*
+ * A program to measure decode time and peak memory of a batch of
+ * images, either decoded at full resolution (REDUCTION = 1) or through
+ * the reduced-resolution ingest path (REDUCTION = 2, 4 or 8, face bands
+ * decoded at full resolution). Run it
+ * once per setting on the same batch to compare, since the peak
+ * resident size only grows within a process.
+ *
+ */
+
+#include "opencv2/objdetect/objdetect.hpp"
+#include "opencv2/highgui/highgui.hpp"
+
+#include "cascade_profile.h"
+#include "image_ingest.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+using namespace cv;
+
+int main(int argc, char** argv)
+{
+    if(argc < 4)
+    {
+        cout << "USAGE: ./IngestBenchmark [FACE_CASCADE] [REDUCTION] [IMAGE]...\n";
+        return 1;
+    }
+
+    CascadeClassifier face_cascade;
+    if(!face_cascade.load(argv[1]))
+    {
+        cout << "Unable to load the cascade " << argv[1] << "\n";
+        return 1;
+    }
+    int reduction = atoi(argv[2]);
+    if(!isReductionSupported(reduction))
+    {
+        cout << "REDUCTION must be 1, 2, 4 or 8\n";
+        return 1;
+    }
+    CascadeParams face_params = defaultCascadeParams("face");
+
+    double decode_time = 0.0, detect_time = 0.0;
+    int total_faces = 0;
+    for(int i = 3; i < argc; ++i)
+    {
+        vector<Rect_<int> > faces;
+        vector<FaceCrop> crops;
+        if(reduction == 1)
+        {
+            int64 start = getTickCount();
+            Mat image = imread(argv[i]);
+            decode_time += (getTickCount() - start) * 1000.0 / getTickFrequency();
+
+            start = getTickCount();
+            runCascade(face_cascade, image, faces, face_params);
+            detect_time += (getTickCount() - start) * 1000.0 / getTickFrequency();
+
+            for(unsigned int j = 0; j < faces.size(); ++j)
+            {
+                FaceCrop crop;
+                crop.face = faces[j];
+                crop.image = image(faces[j]).clone();
+                crops.push_back(crop);
+            }
+        }
+        else
+        {
+            ImageIngest ingest(argv[i], reduction);
+            const Mat& detection_image = ingest.detectionImage();
+
+            int64 start = getTickCount();
+            runCascade(face_cascade, detection_image, faces, ingest.detectionParams(face_params));
+            detect_time += (getTickCount() - start) * 1000.0 / getTickFrequency();
+
+            crops = ingest.decodeFaceCrops(faces);
+            decode_time += ingest.decodeTime();
+        }
+        total_faces += crops.size();
+    }
+
+    cout << "Images: " << (argc - 3) << ", reduction: " << reduction << "\n"
+        << "Faces found: " << total_faces << "\n"
+        << "Decode time: " << decode_time << " ms\n"
+        << "Detection time: " << detect_time << " ms\n"
+        << "Peak resident size: " << peakResidentKB() << " KB\n";
+    return 0;
+}